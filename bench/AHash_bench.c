@@ -0,0 +1,419 @@
+/*
+ * Hash function quality and speed benchmark
+ *
+ * Runs every AHash function over synthetic key sets and reports:
+ *
+ *  - Speed in bytes of key hashed per CPU cycle (per nanosecond where cycles can't be read).
+ *  - Chi-square of the bucket distribution divided by its degrees of freedom, for tables
+ *    of several sizes indexed like AHashtable does (hash & (buckets - 1)). Values near 1.0
+ *    mean the keys are spread like random keys would be, higher values mean more collisions.
+ *  - Avalanche bias: the mean and the largest deviation from 50% of the chance an output bit
+ *    flips when a single input bit flips (0% is ideal, 50% means some input bit doesn't affect
+ *    some output bit). Each input bit is flipped in up to 2^16 keys, so a random hash has a
+ *    mean bias of about 0.2-0.5% and a largest one of about 1-3%.
+ *
+ * Run it using: make bench-hash
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "AHash.h"
+
+#define NUM_KEYS (1 << 16)
+#define SHORT_STRING 12
+#define LONG_STRING 256
+#define AVALANCHE_KEYS NUM_KEYS   /* Keys whose bits are flipped, fewer for long keys */
+#define AVALANCHE_HASHES (1 << 24) /* Hashes computed per case at most */
+#define SPEED_ROUNDS 20
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define TIME_UNIT "cycle"
+static unsigned long long now(void)
+{
+	return __rdtsc();
+}
+#else
+#include <time.h>
+#define TIME_UNIT "ns"
+static unsigned long long now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+#endif
+
+/* A key: 'size' bytes at 'data' */
+typedef struct Key
+{
+	const void* data;
+	size_t size;
+} Key;
+
+typedef struct KeySet
+{
+	const char* name;
+	Key* keys;
+	int strings;  /* whether the keys are strings (and can't contain zero bytes) */
+	void* memory; /* memory of the keys (each string key is allocated on its own) */
+} KeySet;
+
+/* Every hash function is called through an adapter hashing a Key */
+typedef size_t (*HashAdapter)(const Key* key);
+
+/* Batch hash functions hash all the keys of a set at once */
+typedef void (*BatchAdapter)(const KeySet* set, size_t* hashes);
+
+typedef struct HashCase
+{
+	const char* name;
+	HashAdapter hash;
+	BatchAdapter batch; /* used for speed only when not NULL */
+	int strings;        /* 1 - only for strings, 0 - only for fixed-size keys, -1 - for all */
+} HashCase;
+
+static size_t genericHash(const Key* key)
+{
+	return AHash->hash(key->data, key->size);
+}
+
+static size_t incrementalHash(const Key* key)
+{
+	AHashState state;
+
+	AHash->init(&state);
+	AHash->update(&state, key->data, key->size);
+	return AHash->final(&state);
+}
+
+static size_t intHash(const Key* key)
+{
+	return AHash->intHash(key->data);
+}
+
+static size_t pointerHash(const Key* key)
+{
+	return AHash->pointerHash(*(void* const *)key->data);
+}
+
+static size_t stringHash(const Key* key)
+{
+	return AHash->stringHash(key->data);
+}
+
+static size_t combineHash(const Key* key)
+{
+	const unsigned char* bytes = key->data;
+	size_t h = 0, i;
+
+	for (i = 0; i < key->size; i++)
+	{
+		h = AHash->combine(h, bytes[i]);
+	}
+
+	return h;
+}
+
+/* All the fixed-size keys of a set have the same size and are stored contiguously */
+static void hashBatch(const KeySet* set, size_t* hashes)
+{
+	AHash->hashBatch(set->keys[0].data, set->keys[0].size, NUM_KEYS, hashes);
+}
+
+static void stringHashBatch(const KeySet* set, size_t* hashes)
+{
+	static const char* strings[NUM_KEYS];
+	static size_t sizes[NUM_KEYS];
+	size_t i;
+
+	for (i = 0; i < NUM_KEYS; i++)
+	{
+		strings[i] = set->keys[i].data;
+		sizes[i] = set->keys[i].size;
+	}
+
+	AHash->stringHashBatch(strings, sizes, NUM_KEYS, hashes);
+}
+
+static const HashCase cases[] =
+{
+	{ "hash",            genericHash,     NULL,            -1 },
+	{ "init/update/final", incrementalHash, NULL,          -1 },
+	{ "combine (bytes)", combineHash,     NULL,            -1 },
+	{ "intHash",         intHash,         NULL,            0 },
+	{ "pointerHash",     pointerHash,     NULL,            0 },
+	{ "hashBatch",       genericHash,     hashBatch,       0 },
+	{ "stringHash",      stringHash,      NULL,            1 },
+	{ "stringHashBatch", stringHash,      stringHashBatch, 1 },
+};
+
+/*
+ * Whether the hash case fits the key set (the int/pointer hashes need keys of their size)
+ */
+static int fits(const HashCase* hc, const KeySet* set)
+{
+	if (hc->strings != -1 && hc->strings != set->strings)
+	{
+		return 0;
+	}
+
+	if (hc->hash == intHash)
+	{
+		return set->keys[0].size == sizeof(int);
+	}
+
+	if (hc->hash == pointerHash)
+	{
+		return set->keys[0].size == sizeof(void*);
+	}
+
+	return 1;
+}
+
+static double speed(const HashCase* hc, const KeySet* set, size_t* hashes)
+{
+	unsigned long long start, best = (unsigned long long)-1;
+	size_t bytes = 0, round, i;
+
+	for (i = 0; i < NUM_KEYS; i++)
+	{
+		bytes += set->keys[i].size;
+	}
+
+	for (round = 0; round < SPEED_ROUNDS; round++)
+	{
+		start = now();
+
+		if (hc->batch != NULL)
+		{
+			hc->batch(set, hashes);
+		}
+		else
+		{
+			for (i = 0; i < NUM_KEYS; i++)
+			{
+				hashes[i] = hc->hash(&set->keys[i]);
+			}
+		}
+
+		start = now() - start;
+		best = start < best ? start : best;
+	}
+
+	return best > 0 ? (double)bytes / best : 0;
+}
+
+static double chiSquare(const size_t* hashes, size_t buckets)
+{
+	size_t* counts = calloc(buckets, sizeof *counts);
+	double expected = (double)NUM_KEYS / buckets;
+	double chi = 0;
+	size_t i;
+
+	for (i = 0; i < NUM_KEYS; i++)
+	{
+		counts[hashes[i] & (buckets - 1)]++;
+	}
+
+	for (i = 0; i < buckets; i++)
+	{
+		chi += (counts[i] - expected) * (counts[i] - expected) / expected;
+	}
+
+	free(counts);
+	return chi / (buckets - 1);
+}
+
+/*
+ * Avalanche bias of the hash over the key set, the mean one is stored to 'mean'
+ */
+static double avalanche(const HashCase* hc, const KeySet* set, double* mean)
+{
+	const size_t hashBits = 8 * sizeof(size_t);
+	size_t maxBits = 8 * set->keys[0].size;
+	size_t numKeys = AVALANCHE_KEYS;
+	size_t* flips;
+	size_t* trials;
+	unsigned char* buffer;
+	double worst = 0, total = 0;
+	size_t i, in, out, cells = 0;
+
+	for (i = 0; i < NUM_KEYS; i++)
+	{
+		maxBits = set->keys[i].size * 8 > maxBits ? set->keys[i].size * 8 : maxBits;
+	}
+
+	while (numKeys > 1 && numKeys * maxBits > AVALANCHE_HASHES)
+	{
+		numKeys /= 2;
+	}
+
+	flips = calloc(maxBits * hashBits, sizeof *flips);
+	trials = calloc(maxBits, sizeof *trials);
+	buffer = malloc(maxBits / 8 + 1);
+
+	for (i = 0; i < numKeys; i++)
+	{
+		Key key = set->keys[i * (NUM_KEYS / numKeys)];
+		size_t original;
+
+		memcpy(buffer, key.data, key.size);
+		buffer[key.size] = '\0';
+		key.data = buffer;
+		original = hc->hash(&key);
+
+		for (in = 0; in < key.size * 8; in++)
+		{
+			size_t diff;
+
+			buffer[in / 8] ^= 1 << in % 8;
+
+			if (!set->strings || buffer[in / 8] != '\0') /* a string can't have a zero byte */
+			{
+				diff = original ^ hc->hash(&key);
+				trials[in]++;
+
+				for (out = 0; out < hashBits; out++)
+				{
+					flips[in * hashBits + out] += diff >> out & 1;
+				}
+			}
+
+			buffer[in / 8] ^= 1 << in % 8;
+		}
+	}
+
+	for (in = 0; in < maxBits; in++)
+	{
+		for (out = 0; out < hashBits && trials[in] > 0; out++)
+		{
+			double bias = fabs((double)flips[in * hashBits + out] / trials[in] - 0.5);
+			worst = bias > worst ? bias : worst;
+			total += bias;
+			cells++;
+		}
+	}
+
+	*mean = cells > 0 ? total / cells : 0;
+
+	free(flips);
+	free(trials);
+	free(buffer);
+	return worst;
+}
+
+/*
+ * Key sets
+ */
+
+static KeySet sequentialInts(void)
+{
+	static int ints[NUM_KEYS];
+	static Key keys[NUM_KEYS];
+	KeySet set = { "sequential ints", keys, 0, NULL };
+	size_t i;
+
+	for (i = 0; i < NUM_KEYS; i++)
+	{
+		ints[i] = (int)i;
+		keys[i].data = &ints[i];
+		keys[i].size = sizeof *ints;
+	}
+
+	return set;
+}
+
+static KeySet alignedPointers(void)
+{
+	static void* pointers[NUM_KEYS];
+	static Key keys[NUM_KEYS];
+	KeySet set = { "16-aligned pointers", keys, 0, NULL };
+	char* base = set.memory = malloc(16 * NUM_KEYS + 16);
+	size_t i;
+
+	base += 16 - (size_t)base % 16;
+	for (i = 0; i < NUM_KEYS; i++)
+	{
+		pointers[i] = base + 16 * i; /* like consecutive malloc() results */
+		keys[i].data = &pointers[i];
+		keys[i].size = sizeof *pointers;
+	}
+
+	return set;
+}
+
+static KeySet strings(const char* name, size_t size)
+{
+	static Key shortKeys[NUM_KEYS];
+	static Key longKeys[NUM_KEYS];
+	KeySet set = { name, size <= SHORT_STRING ? shortKeys : longKeys, 1, NULL };
+	size_t i;
+
+	for (i = 0; i < NUM_KEYS; i++)
+	{
+		char* string = malloc(size + 1);
+
+		/* Keys with a shared prefix and a unique suffix, like paths or URLs */
+		memset(string, '/', size);
+		sprintf(string + size - 6, "%06x", (unsigned)i);
+		set.keys[i].data = string;
+		set.keys[i].size = size;
+	}
+
+	return set;
+}
+
+static void freeKeySet(KeySet* set)
+{
+	size_t i;
+
+	for (i = 0; set->strings && i < NUM_KEYS; i++)
+	{
+		free((void *)set->keys[i].data);
+	}
+
+	free(set->memory);
+}
+
+int main(void)
+{
+	static size_t hashes[NUM_KEYS];
+	KeySet sets[4];
+	size_t s, c;
+
+	sets[0] = sequentialInts();
+	sets[1] = alignedPointers();
+	sets[2] = strings("short strings", SHORT_STRING);
+	sets[3] = strings("long strings", LONG_STRING);
+
+	printf("%-20s %-18s %12s %10s %10s %10s %17s\n", "keys", "function", "bytes/" TIME_UNIT,
+	       "chi2 2^8", "chi2 2^12", "chi2 2^16", "avalanche avg/max");
+
+	for (s = 0; s < sizeof sets / sizeof *sets; s++)
+	{
+		for (c = 0; c < sizeof cases / sizeof *cases; c++)
+		{
+			const HashCase* hc = &cases[c];
+			double bytesPerTime, worst, mean;
+
+			if (!fits(hc, &sets[s]))
+			{
+				continue;
+			}
+
+			bytesPerTime = speed(hc, &sets[s], hashes);
+			worst = avalanche(hc, &sets[s], &mean);
+
+			printf("%-20s %-18s %12.3f %10.3f %10.3f %10.3f %8.2f%%/%5.2f%%\n", sets[s].name, hc->name, bytesPerTime,
+			       chiSquare(hashes, 1 << 8), chiSquare(hashes, 1 << 12), chiSquare(hashes, 1 << 16),
+			       100 * mean, 100 * worst);
+		}
+
+		freeKeySet(&sets[s]);
+	}
+
+	return 0;
+}
@@ -0,0 +1,358 @@
+#include <stdlib.h>
+#include <string.h> /* for memcpy(), memmove() */
+#include "AStructBase.h"
+#include "AArray.h"
+
+static void*   AArrayGrow(AArray* self, size_t size); /* Private function */
+
+static void*   AArrayCreate(AArray* self, int numArgs, va_list args);
+static void    AArrayClear(AArray* self);
+static void    AArrayDestroy(AArray* self);
+static void*   AArrayAppend(AArray* self, const void* element);
+static void*   AArrayInsert(AArray* self, size_t pos, const void* element);
+static AArray* AArrayRemove(AArray* self, size_t pos, void* element);
+static void*   AArraySet(AArray* self, size_t pos, const void* element);
+static void*   AArrayGet(AArray* self, size_t pos);
+static AArray* AArraySubArray(AArray* self, size_t pos, size_t size);
+static AArray* AArrayCopy(AArray* self);
+static AArray* AArrayJoin(AArray* first, AArray* second);
+static AArray* AArrayReserve(AArray* self, size_t capacity);
+static AArray* AArrayShrinkToFit(AArray* self);
+
+const AArray AArrayProto =
+{
+	AArrayCreate, AArrayClear, AArrayDestroy, AArrayAppend, AArrayInsert, AArrayRemove, AArraySet, AArrayGet,
+	AArraySubArray, AArrayCopy, AArrayJoin, AArrayReserve, AArrayShrinkToFit
+};
+
+/* Address of the element at position 'pos' of the array 'self' */
+#define elementAt(self, pos) ((char *)(self)->elements + (pos) * (self)->elementSize)
+
+/*
+ * Create a new array
+ */
+static void* AArrayCreate(AArray* self, int numArgs, va_list args)
+{
+	const size_t DEFAULT_CAPACITY = 16;
+	int elementSize, capacity;
+
+	/* Missing or invalid element size */
+	if (numArgs < 1 || (elementSize = va_arg(args, int)) <= 0)
+	{
+		free(self);
+		return NULL;
+	}
+
+	/* If the user supplied an additional capacity argument, use it (in case it's valid) */
+	if (numArgs < 2 || (capacity = va_arg(args, int)) <= 0)
+	{
+		capacity = (int)DEFAULT_CAPACITY; /* Otherwise use the default capacity */
+	}
+
+	self->elementSize = elementSize;
+	self->capacity = capacity;
+	self->size = 0;
+	self->elements = malloc(self->capacity * self->elementSize);
+
+	if (self->elements == NULL)
+	{
+		free(self);
+		return NULL;
+	}
+
+	return self;
+}
+
+/**
+ * @fn void (*AArray::clear)(AArray* self)
+ * @param self The array
+ *
+ * Remove all the elements from the array.
+ */
+static void AArrayClear(AArray* self)
+{
+	if (self != NULL)
+	{
+		self->size = 0;
+	}
+}
+
+/**
+ * @fn void (*AArray::destroy)(AArray* self)
+ * @param self The array
+ *
+ * Free all the storage of the array. Any access to a destroyed array is forbidden.
+ */
+static void AArrayDestroy(AArray* self)
+{
+	if (self != NULL)
+	{
+		free(self->elements);
+		free(self);
+	}
+}
+
+/*
+ * Expand the array so it can hold 'size' elements
+ */
+static void* AArrayGrow(AArray* self, size_t size)
+{
+	void* newElements = self->elements;
+	size_t newCapacity = self->capacity;
+
+	if (size > newCapacity)
+	{
+		do
+		{
+			newCapacity *= 2;
+		} while (size > newCapacity);
+
+		if ((newElements = realloc(self->elements, newCapacity * self->elementSize)) == NULL)
+		{
+			return NULL;
+		}
+
+		self->capacity = newCapacity;
+	}
+
+	return self->elements = newElements;
+}
+
+/**
+ * @fn void* (*AArray::append)(AArray* self, const void* element)
+ * @param self The array
+ * @param element Pointer to the element to copy (or NULL for a zeroed element)
+ * @return Pointer to the element in the array or NULL on error
+ */
+static void* AArrayAppend(AArray* self, const void* element)
+{
+	return self != NULL ? AArrayInsert(self, self->size, element) : NULL;
+}
+
+/**
+ * @fn void* (*AArray::insert)(AArray* self, size_t pos, const void* element)
+ * @param self The array
+ * @param pos Position index
+ * @param element Pointer to the element to copy (or NULL for a zeroed element)
+ * @return Pointer to the element in the array or NULL on error
+ *
+ * Inserting at an index other the the last, moves all
+ * the elements after the index one step forward.
+ */
+static void* AArrayInsert(AArray* self, size_t pos, const void* element)
+{
+	if (self != NULL && pos <= self->size && AArrayGrow(self, self->size + 1) != NULL)
+	{
+		memmove(elementAt(self, pos + 1), elementAt(self, pos), (self->size - pos) * self->elementSize);
+		self->size++;
+
+		return AArraySet(self, pos, element);
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn AArray* (*AArray::remove)(AArray* self, size_t pos, void* element)
+ * @param self The array
+ * @param pos Position index
+ * @param element Pointer to copy the removed element to (if it's not NULL)
+ * @return The array or NULL on error
+ *
+ * Remove the position from the array by moving all
+ * the elements after the position one step backwards.
+ */
+static AArray* AArrayRemove(AArray* self, size_t pos, void* element)
+{
+	if (self != NULL && pos < self->size)
+	{
+		if (element != NULL)
+		{
+			memcpy(element, elementAt(self, pos), self->elementSize);
+		}
+
+		self->size--;
+		memmove(elementAt(self, pos), elementAt(self, pos + 1), (self->size - pos) * self->elementSize);
+
+		return self;
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn void* (*AArray::set)(AArray* self, size_t pos, const void* element)
+ * @param self The array
+ * @param pos Position index
+ * @param element Pointer to the element to copy (or NULL for a zeroed element)
+ * @return Pointer to the element in the array or NULL on error
+ *
+ * Set the element at the position. If position equals self->size then
+ * the call would be equivalent to AArray::append().
+ */
+static void* AArraySet(AArray* self, size_t pos, const void* element)
+{
+	if (self != NULL)
+	{
+		if (pos == self->size)
+		{
+			return AArrayAppend(self, element);
+		}
+
+		if (pos < self->size)
+		{
+			if (element != NULL)
+			{
+				memcpy(elementAt(self, pos), element, self->elementSize);
+			}
+			else
+			{
+				memset(elementAt(self, pos), 0, self->elementSize);
+			}
+
+			return elementAt(self, pos);
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn void* (*AArray::get)(AArray* self, size_t pos)
+ * @param self The array
+ * @param pos Position index
+ * @return Pointer to the element at the position or NULL on error
+ */
+static void* AArrayGet(AArray* self, size_t pos)
+{
+	if (self != NULL && pos < self->size)
+	{
+		return elementAt(self, pos);
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn AArray* (*AArray::subArray)(AArray* self, size_t pos, size_t size)
+ * @param self The array
+ * @param pos Position index of the start of the new sub-array
+ * @param size The size of the new sub-array
+ * @return A new sub-array or NULL on error
+ *
+ * Create a new array of the elements starting from the position with the given size.
+ */
+static AArray* AArraySubArray(AArray* self, size_t pos, size_t size)
+{
+	AArray* subArray = NULL;
+
+	/* Check validness of the position and the size */
+	if (self != NULL && size > 0 && pos + size <= self->size)
+	{
+		subArray = AStruct->ANew(AArray, (int)self->elementSize, (int)size);
+
+		if (subArray != NULL)
+		{
+			memcpy(subArray->elements, elementAt(self, pos), size * self->elementSize);
+			subArray->size = size;
+		}
+	}
+
+	return subArray;
+}
+
+/**
+ * @fn AArray* (*AArray::copy)(AArray* self)
+ * @param self The array
+ * @return A new array or NULL on error
+ *
+ * Create a copy of the array.
+ */
+static AArray* AArrayCopy(AArray* self)
+{
+	return self != NULL ? AArraySubArray(self, 0, self->size) : NULL;
+}
+
+/**
+ * @fn AArray* (*AArray::join)(AArray* first, AArray* second)
+ * @param first The first array
+ * @param second The second array
+ * @return The first array or NULL on error
+ *
+ * Join the first array with the second array, which must have elements
+ * of the same size. The second array will be destroyed afterwards.
+ */
+static AArray* AArrayJoin(AArray* first, AArray* second)
+{
+	if (first != NULL && second != NULL && first->elementSize == second->elementSize &&
+	    AArrayGrow(first, first->size + second->size) != NULL)
+	{
+		/* Copy the elements from the second array */
+		memcpy(elementAt(first, first->size), second->elements, second->size * second->elementSize);
+		first->size += second->size;
+		AArrayDestroy(second);
+		return first;
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn AArray* (*AArray::reserve)(AArray* self, size_t capacity)
+ * @param self The array
+ * @param capacity Number of elements
+ * @return The array or NULL on error
+ *
+ * Make sure the array can hold capacity elements without expanding.
+ */
+static AArray* AArrayReserve(AArray* self, size_t capacity)
+{
+	if (self != NULL)
+	{
+		void* newElements;
+
+		if (capacity <= self->capacity)
+		{
+			return self;
+		}
+
+		if ((newElements = realloc(self->elements, capacity * self->elementSize)) != NULL)
+		{
+			self->elements = newElements;
+			self->capacity = capacity;
+			return self;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn AArray* (*AArray::shrinkToFit)(AArray* self)
+ * @param self The array
+ * @return The array or NULL on error
+ *
+ * Free the storage of the array which isn't used by its elements.
+ */
+static AArray* AArrayShrinkToFit(AArray* self)
+{
+	if (self != NULL)
+	{
+		size_t newCapacity = self->size > 0 ? self->size : 1;
+		void* newElements;
+
+		if (newCapacity >= self->capacity)
+		{
+			return self;
+		}
+
+		if ((newElements = realloc(self->elements, newCapacity * self->elementSize)) != NULL)
+		{
+			self->elements = newElements;
+			self->capacity = newCapacity;
+			return self;
+		}
+	}
+
+	return NULL;
+}
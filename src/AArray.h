@@ -0,0 +1,65 @@
+/**
+ * @file AArray.h
+ */
+
+#ifndef AARRAY_H_
+#define AARRAY_H_
+
+#include <stdarg.h>
+#include "AStructBase.h"
+
+typedef struct AArray AArray;
+
+/**
+ * Dynamic array of fixed-size elements
+ *
+ * This data structure is a dynamic array like AVector, but instead of pointers to values it stores
+ * the values themselves (elements), one after the other. Use it for arrays of numbers or small structs,
+ * which don't need to be allocated one by one and are accessed sequentially in memory.
+ *
+ * Elements are copied into the array from pointers to them, and the array gives pointers to the elements
+ * inside it. These pointers are valid until the array is changed by adding or removing elements.
+ *
+ * The arguments passed to @link ANew AStruct->ANew()@endlink to create a new array are:
+ * @code AStruct->ANew(AArray, int elementSize, int capacity)@endcode
+ * @param elementSize Size of each element in bytes
+ * @param [opt]capacity Optional argument to specify the initial capacity of the array (in elements)
+ *
+ * Examples of creating a new array:
+ * @code
+ * struct Point { double x, y; };
+ * AArray* points = AStruct->ANew(AArray, sizeof(struct Point));
+ *
+ * struct Point p = { 1.0, 2.0 };
+ * points->append(points, &p);
+ * ((struct Point *)points->get(points, 0))->x = 3.0;
+ *
+ * // create an array of ints with initial capacity of 100 elements
+ * AArray* ints = AStruct->ANew(AArray, sizeof(int), 100);
+ * @endcode
+ */
+struct AArray
+{
+	void*    (*const create)(AArray* self, int numArgs, va_list args);        /*<  Default creator function called by AStruct->ANew() */
+	void     (*const clear)(AArray* self);                                    /**< Clear all the array */
+	void     (*const destroy)(AArray* self);                                  /**< Destroy the array */
+	void*    (*const append)(AArray* self, const void* element);              /**< Append an element to the end of the array */
+	void*    (*const insert)(AArray* self, size_t pos, const void* element);  /**< Insert an element at the position */
+	AArray*  (*const remove)(AArray* self, size_t pos, void* element);        /**< Remove the position from the array */
+	void*    (*const set)(AArray* self, size_t pos, const void* element);     /**< Set the element at the position */
+	void*    (*const get)(AArray* self, size_t pos);                          /**< Get the element at the position */
+	AArray*  (*const subArray)(AArray* self, size_t pos, size_t size);        /**< Get a sub-array of some size from a position */
+	AArray*  (*const copy)(AArray* self);                                     /**< Copy the entire array */
+	AArray*  (*const join)(AArray* first, AArray* second);                    /**< Join two arrays */
+	AArray*  (*const reserve)(AArray* self, size_t capacity);                 /**< Reserve capacity for a number of elements */
+	AArray*  (*const shrinkToFit)(AArray* self);                              /**< Shrink the capacity to the size */
+
+	void* elements;     /**< The elements, one after the other */
+	size_t elementSize; /**< Size of each element in bytes */
+	size_t size;        /**< Number of elements in the array */
+	size_t capacity;    /*<  The allocated number of elements */
+};
+
+extern const AArray AArrayProto;
+
+#endif /* AARRAY_H_ */
@@ -0,0 +1,559 @@
+#include <stdlib.h>
+#include <string.h> /* for memcpy(), memset() */
+#include "AStructBase.h"
+#include "AInternal.h"
+#include "ABitset.h"
+
+/* Operations combining the words of two bitsets */
+typedef enum ABitsetOp { ABITSET_AND, ABITSET_OR, ABITSET_XOR, ABITSET_ANDNOT } ABitsetOp;
+
+static unsigned long long* ABitsetGrow(ABitset* self, size_t words); /* Private functions */
+static size_t   ABitsetCountWords(const unsigned long long* words, size_t count);
+static void     ABitsetCombineWords(unsigned long long* words, const unsigned long long* other, size_t count, ABitsetOp op);
+static ABitset* ABitsetCombine(ABitset* self, const ABitset* other, ABitsetOp op);
+
+static void*    ABitsetCreate(ABitset* self, int numArgs, va_list args);
+static void     ABitsetClear(ABitset* self);
+static void     ABitsetDestroy(ABitset* self);
+static ABitset* ABitsetSet(ABitset* self, size_t pos);
+static void     ABitsetReset(ABitset* self, size_t pos);
+static int      ABitsetTest(ABitset* self, size_t pos);
+static ABitset* ABitsetResize(ABitset* self, size_t size);
+static size_t   ABitsetCount(ABitset* self);
+static size_t   ABitsetFindNext(ABitset* self, size_t pos);
+static size_t   ABitsetRank(ABitset* self, size_t pos);
+static size_t   ABitsetSelect(ABitset* self, size_t n);
+static ABitset* ABitsetAndWith(ABitset* self, const ABitset* other);
+static ABitset* ABitsetOrWith(ABitset* self, const ABitset* other);
+static ABitset* ABitsetXorWith(ABitset* self, const ABitset* other);
+static ABitset* ABitsetAndNotWith(ABitset* self, const ABitset* other);
+static ABitset* ABitsetCopy(ABitset* self);
+
+const ABitset ABitsetProto =
+{
+	ABitsetCreate, ABitsetClear, ABitsetDestroy, ABitsetSet, ABitsetReset, ABitsetTest, ABitsetResize, ABitsetCount,
+	ABitsetFindNext, ABitsetRank, ABitsetSelect, ABitsetAndWith, ABitsetOrWith, ABitsetXorWith, ABitsetAndNotWith,
+	ABitsetCopy
+};
+
+#define WORD_BITS 64
+
+/* Number of words holding 'bits' bits */
+#define wordsFor(bits) (((bits) + WORD_BITS - 1) / WORD_BITS)
+
+/* The bit of position 'pos' in its word */
+#define bitOf(pos) (1ULL << ((pos) % WORD_BITS))
+
+/*
+ * Create a new bitset
+ */
+static void* ABitsetCreate(ABitset* self, int numArgs, va_list args)
+{
+	int size = 0;
+
+	/* If the user supplied an additional size argument, use it (in case it's valid) */
+	if (numArgs > 0 && (size = va_arg(args, int)) < 0)
+	{
+		size = 0;
+	}
+
+	self->words = NULL;
+	self->size = 0;
+	self->capacity = 0;
+
+	if (ABitsetResize(self, (size_t)size) == NULL)
+	{
+		free(self);
+		return NULL;
+	}
+
+	return self;
+}
+
+/**
+ * @fn void (*ABitset::clear)(ABitset* self)
+ * @param self The bitset
+ *
+ * Remove all the bits from the bitset (its size becomes 0).
+ */
+static void ABitsetClear(ABitset* self)
+{
+	if (self != NULL)
+	{
+		ABitsetResize(self, 0);
+	}
+}
+
+/**
+ * @fn void (*ABitset::destroy)(ABitset* self)
+ * @param self The bitset
+ *
+ * Free all the storage of the bitset. Any access to a destroyed bitset is forbidden.
+ */
+static void ABitsetDestroy(ABitset* self)
+{
+	if (self != NULL)
+	{
+		free(self->words);
+		free(self);
+	}
+}
+
+/*
+ * Expand the storage so it can hold 'words' words
+ */
+static unsigned long long* ABitsetGrow(ABitset* self, size_t words)
+{
+	const size_t MIN_CAPACITY = 4;
+	size_t newCapacity = self->capacity < MIN_CAPACITY ? MIN_CAPACITY : self->capacity;
+	unsigned long long* newWords;
+
+	if (words <= self->capacity && self->words != NULL)
+	{
+		return self->words;
+	}
+
+	while (words > newCapacity)
+	{
+		newCapacity *= 2;
+	}
+
+	if ((newWords = realloc(self->words, newCapacity * sizeof *newWords)) == NULL)
+	{
+		return NULL;
+	}
+
+	self->capacity = newCapacity;
+	return self->words = newWords;
+}
+
+/**
+ * @fn ABitset* (*ABitset::resize)(ABitset* self, size_t size)
+ * @param self The bitset
+ * @param size The new number of bits
+ * @return The bitset or NULL on error
+ *
+ * Change the number of bits of the bitset. New bits are 0, and the bits past the new size are removed.
+ */
+static ABitset* ABitsetResize(ABitset* self, size_t size)
+{
+	size_t oldWords, newWords = wordsFor(size);
+
+	if (self == NULL || ABitsetGrow(self, newWords) == NULL)
+	{
+		return NULL;
+	}
+
+	oldWords = wordsFor(self->size);
+
+	if (newWords > oldWords)
+	{
+		memset(self->words + oldWords, 0, (newWords - oldWords) * sizeof *self->words);
+	}
+	else if (size % WORD_BITS != 0)
+	{
+		self->words[newWords - 1] &= bitOf(size) - 1; /* Keep the bits past the size 0 */
+	}
+
+	self->size = size;
+	return self;
+}
+
+/**
+ * @fn ABitset* (*ABitset::set)(ABitset* self, size_t pos)
+ * @param self The bitset
+ * @param pos Position index
+ * @return The bitset or NULL on error
+ *
+ * Set the bit at the position to 1. Positions past the end of the bitset expand it.
+ */
+static ABitset* ABitsetSet(ABitset* self, size_t pos)
+{
+	if (self == NULL || (pos >= self->size && ABitsetResize(self, pos + 1) == NULL))
+	{
+		return NULL;
+	}
+
+	self->words[pos / WORD_BITS] |= bitOf(pos);
+	return self;
+}
+
+/**
+ * @fn void (*ABitset::reset)(ABitset* self, size_t pos)
+ * @param self The bitset
+ * @param pos Position index
+ *
+ * Set the bit at the position to 0. Positions past the end of the bitset are 0 already.
+ */
+static void ABitsetReset(ABitset* self, size_t pos)
+{
+	if (self != NULL && pos < self->size)
+	{
+		self->words[pos / WORD_BITS] &= ~bitOf(pos);
+	}
+}
+
+/**
+ * @fn int (*ABitset::test)(ABitset* self, size_t pos)
+ * @param self The bitset
+ * @param pos Position index
+ * @return Non-zero if the bit at the position is 1, or zero otherwise (or if it's past the end)
+ */
+static int ABitsetTest(ABitset* self, size_t pos)
+{
+	return self != NULL && pos < self->size && (self->words[pos / WORD_BITS] & bitOf(pos)) != 0;
+}
+
+/*
+ * Bulk operations
+ *
+ * Counting uses the POPCNT instruction, and combining bitsets combines 4 words at a time using AVX2, where
+ * the CPU has them. Plain loops are used elsewhere.
+ */
+
+#if defined(A_X86_SIMD) && defined(__x86_64__)
+#define ABITSET_SIMD
+#endif
+
+#ifdef ABITSET_SIMD
+
+A_TARGET("popcnt") static size_t ABitsetCountPOPCNT(const unsigned long long* words, size_t count)
+{
+	size_t i, bits = 0;
+
+	for (i = 0; i < count; i++)
+	{
+		bits += APopCount(words[i]);
+	}
+
+	return bits;
+}
+
+A_TARGET("avx2") static void ABitsetCombineAVX2(unsigned long long* words, const unsigned long long* other,
+                                                 size_t count, ABitsetOp op)
+{
+	size_t i;
+
+	/* Switch outside of the loops, so each loop is a single instruction per 4 words */
+	switch (op)
+	{
+	case ABITSET_AND:
+		for (i = 0; i + 4 <= count; i += 4)
+		{
+			_mm256_storeu_si256((__m256i *)(words + i), _mm256_and_si256(_mm256_loadu_si256((const __m256i *)(words + i)),
+			                                                             _mm256_loadu_si256((const __m256i *)(other + i))));
+		}
+		break;
+	case ABITSET_OR:
+		for (i = 0; i + 4 <= count; i += 4)
+		{
+			_mm256_storeu_si256((__m256i *)(words + i), _mm256_or_si256(_mm256_loadu_si256((const __m256i *)(words + i)),
+			                                                            _mm256_loadu_si256((const __m256i *)(other + i))));
+		}
+		break;
+	case ABITSET_XOR:
+		for (i = 0; i + 4 <= count; i += 4)
+		{
+			_mm256_storeu_si256((__m256i *)(words + i), _mm256_xor_si256(_mm256_loadu_si256((const __m256i *)(words + i)),
+			                                                             _mm256_loadu_si256((const __m256i *)(other + i))));
+		}
+		break;
+	default: /* _mm256_andnot_si256(a, b) is ~a & b */
+		for (i = 0; i + 4 <= count; i += 4)
+		{
+			_mm256_storeu_si256((__m256i *)(words + i), _mm256_andnot_si256(_mm256_loadu_si256((const __m256i *)(other + i)),
+			                                                                _mm256_loadu_si256((const __m256i *)(words + i))));
+		}
+		break;
+	}
+
+	if (i < count)
+	{
+		ABitsetCombineWords(words + i, other + i, count - i, op); /* The words left are too few for AVX2 */
+	}
+}
+
+#endif /* ABITSET_SIMD */
+
+/*
+ * Number of bits which are 1 in 'count' words
+ */
+static size_t ABitsetCountWords(const unsigned long long* words, size_t count)
+{
+	size_t i, bits = 0;
+
+#ifdef ABITSET_SIMD
+	if (A_CPU_SUPPORTS("popcnt"))
+	{
+		return ABitsetCountPOPCNT(words, count);
+	}
+#endif
+
+	for (i = 0; i < count; i++)
+	{
+		bits += APopCount(words[i]);
+	}
+
+	return bits;
+}
+
+/*
+ * Combine 'count' words with the words of 'other' by 'op'
+ */
+static void ABitsetCombineWords(unsigned long long* words, const unsigned long long* other, size_t count, ABitsetOp op)
+{
+	size_t i;
+
+#ifdef ABITSET_SIMD
+	if (count >= 4 && A_CPU_SUPPORTS("avx2"))
+	{
+		ABitsetCombineAVX2(words, other, count, op);
+		return;
+	}
+#endif
+
+	for (i = 0; i < count; i++)
+	{
+		switch (op)
+		{
+		case ABITSET_AND:
+			words[i] &= other[i];
+			break;
+		case ABITSET_OR:
+			words[i] |= other[i];
+			break;
+		case ABITSET_XOR:
+			words[i] ^= other[i];
+			break;
+		default:
+			words[i] &= ~other[i];
+			break;
+		}
+	}
+}
+
+/*
+ * Combine the bitset with another bitset by 'op'. Uniting bitsets (or keeping the bits which are 1
+ * in only one of them) expands the bitset to the size of the other bitset if it's larger.
+ */
+static ABitset* ABitsetCombine(ABitset* self, const ABitset* other, ABitsetOp op)
+{
+	size_t words, otherWords;
+
+	if (self == NULL || other == NULL)
+	{
+		return NULL;
+	}
+
+	if ((op == ABITSET_OR || op == ABITSET_XOR) && other->size > self->size && ABitsetResize(self, other->size) == NULL)
+	{
+		return NULL;
+	}
+
+	words = wordsFor(self->size);
+	otherWords = wordsFor(other->size);
+
+	if (otherWords < words)
+	{
+		if (op == ABITSET_AND) /* The bits past the other bitset are 0 there */
+		{
+			memset(self->words + otherWords, 0, (words - otherWords) * sizeof *self->words);
+		}
+
+		words = otherWords;
+	}
+
+	ABitsetCombineWords(self->words, other->words, words, op);
+	return self;
+}
+
+/**
+ * @fn size_t (*ABitset::count)(ABitset* self)
+ * @param self The bitset
+ * @return Number of bits which are 1
+ */
+static size_t ABitsetCount(ABitset* self)
+{
+	return self != NULL ? ABitsetCountWords(self->words, wordsFor(self->size)) : 0;
+}
+
+/**
+ * @fn size_t (*ABitset::findNext)(ABitset* self, size_t pos)
+ * @param self The bitset
+ * @param pos Position index to start from
+ * @return Position of the first bit which is 1 from the position, or @ref ABITSET_NPOS if there's none
+ *
+ * Bits which are 0 are skipped a word at a time.
+ */
+static size_t ABitsetFindNext(ABitset* self, size_t pos)
+{
+	size_t w, words;
+	unsigned long long word;
+
+	if (self == NULL || pos >= self->size)
+	{
+		return ABITSET_NPOS;
+	}
+
+	words = wordsFor(self->size);
+	w = pos / WORD_BITS;
+	word = self->words[w] & ~(bitOf(pos) - 1);
+
+	while (word == 0)
+	{
+		if (++w == words)
+		{
+			return ABITSET_NPOS;
+		}
+
+		word = self->words[w];
+	}
+
+	return w * WORD_BITS + ACountTrailingZeros(word);
+}
+
+/**
+ * @fn size_t (*ABitset::rank)(ABitset* self, size_t pos)
+ * @param self The bitset
+ * @param pos Position index
+ * @return Number of bits which are 1 before the position
+ *
+ * Count the bits a word at a time, in O(pos / 64) time.
+ */
+static size_t ABitsetRank(ABitset* self, size_t pos)
+{
+	size_t rank;
+
+	if (self == NULL)
+	{
+		return 0;
+	}
+
+	if (pos >= self->size)
+	{
+		return ABitsetCount(self);
+	}
+
+	rank = ABitsetCountWords(self->words, pos / WORD_BITS);
+	return rank + APopCount(self->words[pos / WORD_BITS] & (bitOf(pos) - 1));
+}
+
+/**
+ * @fn size_t (*ABitset::select)(ABitset* self, size_t n)
+ * @param self The bitset
+ * @param n Number of bits which are 1 before the bit to find
+ * @return Position of the bit which is 1 and has n bits which are 1 before it (the first one for 0),
+ * or @ref ABITSET_NPOS if there are no more than n bits which are 1
+ *
+ * The inverse of ABitset::rank(): rank(select(n)) is n. Bits are counted a word at a time.
+ */
+static size_t ABitsetSelect(ABitset* self, size_t n)
+{
+	size_t w, words, bits;
+	unsigned long long word;
+
+	if (self == NULL)
+	{
+		return ABITSET_NPOS;
+	}
+
+	words = wordsFor(self->size);
+
+	for (w = 0; w < words; w++)
+	{
+		bits = APopCount(self->words[w]);
+
+		if (n < bits)
+		{
+			/* Drop the lowest n bits of the word, the bit is the lowest one left */
+			for (word = self->words[w]; n > 0; n--)
+			{
+				word &= word - 1;
+			}
+
+			return w * WORD_BITS + ACountTrailingZeros(word);
+		}
+
+		n -= bits;
+	}
+
+	return ABITSET_NPOS;
+}
+
+/**
+ * @fn ABitset* (*ABitset::andWith)(ABitset* self, const ABitset* other)
+ * @param self The bitset
+ * @param other The other bitset
+ * @return The bitset or NULL on error
+ *
+ * Set the bits which are 0 in the other bitset to 0. Bits past the end of the other bitset are 0.
+ */
+static ABitset* ABitsetAndWith(ABitset* self, const ABitset* other)
+{
+	return ABitsetCombine(self, other, ABITSET_AND);
+}
+
+/**
+ * @fn ABitset* (*ABitset::orWith)(ABitset* self, const ABitset* other)
+ * @param self The bitset
+ * @param other The other bitset
+ * @return The bitset or NULL on error
+ *
+ * Set the bits which are 1 in the other bitset to 1. The bitset expands to the size of the other bitset,
+ * if it's larger.
+ */
+static ABitset* ABitsetOrWith(ABitset* self, const ABitset* other)
+{
+	return ABitsetCombine(self, other, ABITSET_OR);
+}
+
+/**
+ * @fn ABitset* (*ABitset::xorWith)(ABitset* self, const ABitset* other)
+ * @param self The bitset
+ * @param other The other bitset
+ * @return The bitset or NULL on error
+ *
+ * Flip the bits which are 1 in the other bitset. The bitset expands to the size of the other bitset,
+ * if it's larger.
+ */
+static ABitset* ABitsetXorWith(ABitset* self, const ABitset* other)
+{
+	return ABitsetCombine(self, other, ABITSET_XOR);
+}
+
+/**
+ * @fn ABitset* (*ABitset::andNotWith)(ABitset* self, const ABitset* other)
+ * @param self The bitset
+ * @param other The other bitset
+ * @return The bitset or NULL on error
+ *
+ * Set the bits which are 1 in the other bitset to 0.
+ */
+static ABitset* ABitsetAndNotWith(ABitset* self, const ABitset* other)
+{
+	return ABitsetCombine(self, other, ABITSET_ANDNOT);
+}
+
+/**
+ * @fn ABitset* (*ABitset::copy)(ABitset* self)
+ * @param self The bitset
+ * @return A new bitset or NULL on error
+ */
+static ABitset* ABitsetCopy(ABitset* self)
+{
+	ABitset* copy;
+
+	if (self == NULL || (copy = AStruct->ANew(ABitset)) == NULL)
+	{
+		return NULL;
+	}
+
+	if (ABitsetResize(copy, self->size) == NULL)
+	{
+		ABitsetDestroy(copy);
+		return NULL;
+	}
+
+	memcpy(copy->words, self->words, wordsFor(self->size) * sizeof *self->words);
+	return copy;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file ABitset.h
+ */
+
+#ifndef ABITSET_H_
+#define ABITSET_H_
+
+#include <stdarg.h>
+#include "AStructBase.h"
+
+/**
+ * Position returned by @link ABitset bitset@endlink functions when there's no such bit
+ */
+#define ABITSET_NPOS ((size_t)-1)
+
+typedef struct ABitset ABitset;
+
+/**
+ * Dynamic bitset
+ *
+ * This data structure is a dynamic array of bits, stored 64 bits to a word. Use it for sets of small
+ * integers (such as IDs) or flags, which take a bit each instead of a value of their own. Whole bitsets
+ * are combined (intersected, united and so on) a word at a time, using AVX2 instructions where the CPU has
+ * them, and bits are counted using the POPCNT instruction where the CPU has it.
+ *
+ * Setting a bit past the end of the bitset expands it. All the new bits are 0.
+ *
+ * The arguments passed to @link ANew AStruct->ANew()@endlink to create a new bitset are:
+ * @code AStruct->ANew(ABitset, int size)@endcode
+ * @param [opt]size Optional argument to specify the initial number of bits (all of them 0)
+ *
+ * Example of intersecting sets of IDs:
+ * @code
+ * ABitset* candidates = AStruct->ANew(ABitset);
+ * ABitset* matches = AStruct->ANew(ABitset);
+ * size_t id;
+ *
+ * candidates->set(candidates, 17);
+ * matches->set(matches, 17);
+ * candidates->andWith(candidates, matches);
+ *
+ * for (id = candidates->findNext(candidates, 0); id != ABITSET_NPOS; id = candidates->findNext(candidates, id + 1))
+ *     ...
+ * @endcode
+ */
+struct ABitset
+{
+	void*    (*const create)(ABitset* self, int numArgs, va_list args);  /*<  Default creator function called by AStruct->ANew() */
+	void     (*const clear)(ABitset* self);                              /**< Remove all the bits */
+	void     (*const destroy)(ABitset* self);                            /**< Destroy the bitset */
+	ABitset* (*const set)(ABitset* self, size_t pos);                    /**< Set the bit at the position to 1 */
+	void     (*const reset)(ABitset* self, size_t pos);                  /**< Set the bit at the position to 0 */
+	int      (*const test)(ABitset* self, size_t pos);                   /**< Get the bit at the position */
+	ABitset* (*const resize)(ABitset* self, size_t size);                /**< Change the number of bits */
+	size_t   (*const count)(ABitset* self);                              /**< Count the bits which are 1 */
+	size_t   (*const findNext)(ABitset* self, size_t pos);               /**< Find the next bit which is 1 */
+	size_t   (*const rank)(ABitset* self, size_t pos);                   /**< Count the bits which are 1 before a position */
+	size_t   (*const select)(ABitset* self, size_t n);                   /**< Find the n'th bit which is 1 */
+	ABitset* (*const andWith)(ABitset* self, const ABitset* other);      /**< Intersect with another bitset */
+	ABitset* (*const orWith)(ABitset* self, const ABitset* other);       /**< Unite with another bitset */
+	ABitset* (*const xorWith)(ABitset* self, const ABitset* other);      /**< Keep the bits which are 1 in only one of the bitsets */
+	ABitset* (*const andNotWith)(ABitset* self, const ABitset* other);   /**< Remove the bits of another bitset */
+	ABitset* (*const copy)(ABitset* self);                               /**< Copy the entire bitset */
+
+	unsigned long long* words; /*<  The bits, 64 to a word from the lowest bit. Bits past the size are 0. */
+	size_t size;               /**< Number of bits in the bitset */
+	size_t capacity;           /*<  The allocated number of words */
+};
+
+extern const ABitset ABitsetProto;
+
+#endif /* ABITSET_H_ */
@@ -0,0 +1,376 @@
+#include <stdlib.h>
+#include <string.h> /* for memcpy(), memset() */
+#include "AStructBase.h"
+#include "AInternal.h"
+#include "AParallel.h"
+#include "AColumnar.h"
+
+static void*      AColumnarGrow(AColumnar* self, size_t size); /* Private functions */
+static void       AColumnarFree(AColumnar* self);
+static void       AColumnarScanChunk(void* arg, size_t index);
+
+static void*      AColumnarCreate(AColumnar* self, int numArgs, va_list args);
+static void       AColumnarClear(AColumnar* self);
+static void       AColumnarDestroy(AColumnar* self);
+static AColumnar* AColumnarAppend(AColumnar* self, const void* row);
+static AColumnar* AColumnarSet(AColumnar* self, size_t pos, const void* row);
+static void*      AColumnarGet(AColumnar* self, size_t pos, void* row);
+static void*      AColumnarAt(AColumnar* self, size_t pos, size_t column);
+static void*      AColumnarColumn(AColumnar* self, size_t column);
+static AColumnar* AColumnarReserve(AColumnar* self, size_t capacity);
+static AColumnar* AColumnarScan(AColumnar* self, size_t column, size_t chunks, AColumnarScanFunc func, void* arg);
+
+const AColumnar AColumnarProto =
+{
+	AColumnarCreate, AColumnarClear, AColumnarDestroy, AColumnarAppend, AColumnarSet, AColumnarGet, AColumnarAt,
+	AColumnarColumn, AColumnarReserve, AColumnarScan
+};
+
+/* Address of the field of column 'c' at position 'pos' of the table 'self' */
+#define fieldAt(self, pos, c) ((char *)(self)->columns[c] + (pos) * (self)->sizes[c])
+
+/* A column scan split across threads */
+typedef struct AColumnarScanJob
+{
+	const char* values;
+	size_t valueSize;
+	size_t size;
+	size_t chunks;
+	AColumnarScanFunc func;
+	void* arg;
+} AColumnarScanJob;
+
+/*
+ * Create a new columnar table
+ */
+static void* AColumnarCreate(AColumnar* self, int numArgs, va_list args)
+{
+	const size_t DEFAULT_CAPACITY = 16;
+	const size_t* sizes;
+	int columns, capacity;
+	size_t c;
+
+	/* Missing or invalid columns */
+	if (numArgs < 2 || (columns = va_arg(args, int)) <= 0 || (sizes = va_arg(args, const size_t*)) == NULL)
+	{
+		free(self);
+		return NULL;
+	}
+
+	/* If the user supplied an additional capacity argument, use it (in case it's valid) */
+	if (numArgs < 3 || (capacity = va_arg(args, int)) <= 0)
+	{
+		capacity = (int)DEFAULT_CAPACITY; /* Otherwise use the default capacity */
+	}
+
+	self->numColumns = (size_t)columns;
+	self->capacity = (size_t)capacity;
+	self->size = 0;
+	self->rowSize = 0;
+	self->sizes = malloc(self->numColumns * sizeof *self->sizes);
+	self->columns = calloc(self->numColumns, sizeof *self->columns);
+
+	if (self->sizes == NULL || self->columns == NULL)
+	{
+		AColumnarFree(self);
+		return NULL;
+	}
+
+	for (c = 0; c < self->numColumns; c++)
+	{
+		self->sizes[c] = sizes[c];
+		self->rowSize += sizes[c];
+
+		if (sizes[c] == 0 || (self->columns[c] = malloc(self->capacity * sizes[c])) == NULL)
+		{
+			AColumnarFree(self);
+			return NULL;
+		}
+	}
+
+	return self;
+}
+
+/*
+ * Free all the storage of the table
+ */
+static void AColumnarFree(AColumnar* self)
+{
+	size_t c;
+
+	if (self->columns != NULL)
+	{
+		for (c = 0; c < self->numColumns; c++)
+		{
+			free(self->columns[c]);
+		}
+	}
+
+	free(self->columns);
+	free(self->sizes);
+	free(self);
+}
+
+/**
+ * @fn void (*AColumnar::clear)(AColumnar* self)
+ * @param self The columnar table
+ *
+ * Remove all the rows from the table.
+ */
+static void AColumnarClear(AColumnar* self)
+{
+	if (self != NULL)
+	{
+		self->size = 0;
+	}
+}
+
+/**
+ * @fn void (*AColumnar::destroy)(AColumnar* self)
+ * @param self The columnar table
+ *
+ * Free all the storage of the table. Any access to a destroyed table is forbidden.
+ */
+static void AColumnarDestroy(AColumnar* self)
+{
+	if (self != NULL)
+	{
+		AColumnarFree(self);
+	}
+}
+
+/*
+ * Expand the table so it can hold 'size' rows. Columns which were expanded before
+ * one of them failed to expand just stay larger.
+ */
+static void* AColumnarGrow(AColumnar* self, size_t size)
+{
+	size_t newCapacity = self->capacity;
+	size_t c;
+
+	if (size > newCapacity)
+	{
+		do
+		{
+			newCapacity *= 2;
+		} while (size > newCapacity);
+
+		for (c = 0; c < self->numColumns; c++)
+		{
+			void* newColumn = realloc(self->columns[c], newCapacity * self->sizes[c]);
+
+			if (newColumn == NULL)
+			{
+				return NULL;
+			}
+
+			self->columns[c] = newColumn;
+		}
+
+		self->capacity = newCapacity;
+	}
+
+	return self->columns;
+}
+
+/**
+ * @fn AColumnar* (*AColumnar::append)(AColumnar* self, const void* row)
+ * @param self The columnar table
+ * @param row Pointer to the packed row to copy (or NULL for a zeroed row)
+ * @return The table or NULL on error
+ */
+static AColumnar* AColumnarAppend(AColumnar* self, const void* row)
+{
+	if (self != NULL && AColumnarGrow(self, self->size + 1) != NULL)
+	{
+		self->size++;
+		return AColumnarSet(self, self->size - 1, row);
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn AColumnar* (*AColumnar::set)(AColumnar* self, size_t pos, const void* row)
+ * @param self The columnar table
+ * @param pos Position index
+ * @param row Pointer to the packed row to copy (or NULL for a zeroed row)
+ * @return The table or NULL on error
+ *
+ * Set the fields of the row at the position. If position equals self->size then
+ * the call would be equivalent to AColumnar::append().
+ */
+static AColumnar* AColumnarSet(AColumnar* self, size_t pos, const void* row)
+{
+	const char* field = row;
+	size_t c;
+
+	if (self == NULL || pos > self->size)
+	{
+		return NULL;
+	}
+
+	if (pos == self->size)
+	{
+		return AColumnarAppend(self, row);
+	}
+
+	for (c = 0; c < self->numColumns; c++)
+	{
+		if (field != NULL)
+		{
+			memcpy(fieldAt(self, pos, c), field, self->sizes[c]);
+			field += self->sizes[c];
+		}
+		else
+		{
+			memset(fieldAt(self, pos, c), 0, self->sizes[c]);
+		}
+	}
+
+	return self;
+}
+
+/**
+ * @fn void* (*AColumnar::get)(AColumnar* self, size_t pos, void* row)
+ * @param self The columnar table
+ * @param pos Position index
+ * @param row Pointer to copy the packed row to (@link AColumnar::rowSize self->rowSize@endlink bytes)
+ * @return row, or NULL on error
+ *
+ * Copy the fields of the row at the position. Each field is read from a different column,
+ * so use AColumnar::at() to read a few fields of a row.
+ */
+static void* AColumnarGet(AColumnar* self, size_t pos, void* row)
+{
+	char* field = row;
+	size_t c;
+
+	if (self == NULL || row == NULL || pos >= self->size)
+	{
+		return NULL;
+	}
+
+	for (c = 0; c < self->numColumns; c++)
+	{
+		memcpy(field, fieldAt(self, pos, c), self->sizes[c]);
+		field += self->sizes[c];
+	}
+
+	return row;
+}
+
+/**
+ * @fn void* (*AColumnar::at)(AColumnar* self, size_t pos, size_t column)
+ * @param self The columnar table
+ * @param pos Position index of the row
+ * @param column Index of the column
+ * @return Pointer to the field of the column in the row or NULL on error
+ */
+static void* AColumnarAt(AColumnar* self, size_t pos, size_t column)
+{
+	if (self != NULL && pos < self->size && column < self->numColumns)
+	{
+		return fieldAt(self, pos, column);
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn void* (*AColumnar::column)(AColumnar* self, size_t column)
+ * @param self The columnar table
+ * @param column Index of the column
+ * @return The array of the values of the column or NULL on error
+ *
+ * The array holds the values of the column of all the rows, one after the other
+ * (@link AColumnar::size self->size@endlink values of
+ * @link AColumnar::sizes self->sizes[column]@endlink bytes each).
+ */
+static void* AColumnarColumn(AColumnar* self, size_t column)
+{
+	if (self != NULL && column < self->numColumns)
+	{
+		return self->columns[column];
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn AColumnar* (*AColumnar::reserve)(AColumnar* self, size_t capacity)
+ * @param self The columnar table
+ * @param capacity Number of rows
+ * @return The table or NULL on error
+ *
+ * Make sure the table can hold capacity rows without expanding.
+ */
+static AColumnar* AColumnarReserve(AColumnar* self, size_t capacity)
+{
+	if (self != NULL && AColumnarGrow(self, capacity) != NULL)
+	{
+		return self;
+	}
+
+	return NULL;
+}
+
+static void AColumnarScanChunk(void* arg, size_t index)
+{
+	AColumnarScanJob* job = arg;
+	size_t first = ASplit(job->size, index, job->chunks);
+	size_t last = ASplit(job->size, index + 1, job->chunks);
+
+	job->func(job->arg, index, job->values + first * job->valueSize, first, last - first);
+}
+
+/**
+ * @fn AColumnar* (*AColumnar::scan)(AColumnar* self, size_t column, size_t chunks, AColumnarScanFunc func, void* arg)
+ * @param self The columnar table
+ * @param column Index of the column
+ * @param chunks Number of chunks to split the rows into
+ * @param func The function to call for each chunk
+ * @param arg Argument passed to each call to func
+ * @return The table or NULL on error
+ *
+ * Split the rows into chunks of (almost) the same size, and call func for every chunk with the values of
+ * the column in the chunk. The chunks are scanned at the same time by the threads of ::AParallel, so func
+ * mustn't write the same memory for different chunks: to aggregate a column, keep a partial result per chunk
+ * and combine the partial results after the scan. Use @link AParallel::threads AParallel->threads()@endlink
+ * chunks (or a few times as many, if chunks take different times to scan).
+ *
+ * Example of summing a column of ints:
+ * @code
+ * void sumChunk(void* arg, size_t chunk, const void* values, size_t first, size_t count)
+ * {
+ *     long* sums = arg;
+ *     size_t i;
+ *
+ *     for (i = 0; i < count; i++)
+ *         sums[chunk] += ((const int *)values)[i];
+ * }
+ *
+ * size_t chunks = AParallel->threads();
+ * long* sums = calloc(chunks, sizeof(long));
+ * table->scan(table, 1, chunks, sumChunk, sums);
+ * @endcode
+ */
+static AColumnar* AColumnarScan(AColumnar* self, size_t column, size_t chunks, AColumnarScanFunc func, void* arg)
+{
+	AColumnarScanJob job;
+
+	if (self == NULL || column >= self->numColumns || chunks == 0 || func == NULL)
+	{
+		return NULL;
+	}
+
+	job.values = self->columns[column];
+	job.valueSize = self->sizes[column];
+	job.size = self->size;
+	job.chunks = chunks;
+	job.func = func;
+	job.arg = arg;
+	AParallel->run(AColumnarScanChunk, &job, chunks);
+
+	return self;
+}
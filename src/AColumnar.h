@@ -0,0 +1,87 @@
+/**
+ * @file AColumnar.h
+ */
+
+#ifndef ACOLUMNAR_H_
+#define ACOLUMNAR_H_
+
+#include <stdarg.h>
+#include "AStructBase.h"
+
+/**
+ * Columnar scan function type
+ * @param arg The argument passed to AColumnar::scan()
+ * @param chunk Index of the chunk, from 0 to the number of chunks - 1
+ * @param values Pointer to the values of the column in the chunk, one after the other
+ * @param first Position of the first row of the chunk
+ * @param count Number of rows in the chunk (may be 0)
+ *
+ * This function is callbacked by AColumnar::scan for every chunk of the rows.
+ * Chunks are scanned at the same time by different threads.
+ */
+typedef void (*AColumnarScanFunc)(void* arg, size_t chunk, const void* values, size_t first, size_t count);
+
+typedef struct AColumnar AColumnar;
+
+/**
+ * Columnar table of fixed-size fields
+ *
+ * This data structure is a dynamic array of rows of fixed-size fields, like an AArray of structs, which
+ * stores every field (column) in an array of its own instead of storing the rows one after the other.
+ * Use it for tables of many fields which are mostly read a column or two at a time: a scan of one column
+ * reads consecutive memory which holds only the values of that column, and it can use vectorized loops
+ * over the array of the column (see AColumnar::column()). Large columns are scanned by all the threads
+ * of ::AParallel using AColumnar::scan().
+ *
+ * Rows are copied in and out as packed rows: the fields one after the other in column order, with
+ * no padding between them. A single field is accessed in place using AColumnar::at(). Pointers to the
+ * fields and the columns are valid until rows are added to the table.
+ *
+ * The arguments passed to @link ANew AStruct->ANew()@endlink to create a new columnar table are:
+ * @code AStruct->ANew(AColumnar, int columns, const size_t* sizes, int capacity)@endcode
+ * @param columns Number of columns
+ * @param sizes Array of the sizes of the fields of the columns, in bytes
+ * @param [opt]capacity Optional argument to specify the initial capacity of the table (in rows)
+ *
+ * Example of creating a new columnar table and summing a column:
+ * @code
+ * struct Trade { double price; int quantity; int venue; };  // No padding
+ * const size_t sizes[] = { sizeof(double), sizeof(int), sizeof(int) };
+ * AColumnar* trades = AStruct->ANew(AColumnar, 3, sizes);
+ * struct Trade trade = { 9.5, 100, 3 };
+ * const int* quantities;
+ * long total = 0;
+ * size_t i;
+ *
+ * trades->append(trades, &trade);
+ * quantities = trades->column(trades, 1);
+ *
+ * for (i = 0; i < trades->size; i++)
+ *     total += quantities[i];
+ * @endcode
+ */
+struct AColumnar
+{
+	void*      (*const create)(AColumnar* self, int numArgs, va_list args);           /*<  Default creator function called by AStruct->ANew() */
+	void       (*const clear)(AColumnar* self);                                       /**< Clear all the table */
+	void       (*const destroy)(AColumnar* self);                                     /**< Destroy the table */
+	AColumnar* (*const append)(AColumnar* self, const void* row);                     /**< Append a row to the end of the table */
+	AColumnar* (*const set)(AColumnar* self, size_t pos, const void* row);            /**< Set the row at the position */
+	void*      (*const get)(AColumnar* self, size_t pos, void* row);                  /**< Copy the row at the position */
+	void*      (*const at)(AColumnar* self, size_t pos, size_t column);               /**< Get a pointer to a field of a row */
+	void*      (*const column)(AColumnar* self, size_t column);                       /**< Get the array of the values of a column */
+	AColumnar* (*const reserve)(AColumnar* self, size_t capacity);                    /**< Reserve capacity for a number of rows */
+	AColumnar* (*const scan)(AColumnar* self, size_t column, size_t chunks,
+	                         AColumnarScanFunc func, void* arg);                      /**< Scan a column in parallel */
+
+	size_t numColumns; /**< Number of columns */
+	size_t* sizes;     /**< Size of the field of each column in bytes */
+	size_t rowSize;    /**< Size of a packed row in bytes */
+	void** columns;    /*<  The array of the values of each column */
+	size_t size;       /**< Number of rows in the table */
+	size_t capacity;   /*<  The allocated number of rows */
+};
+
+extern const AColumnar AColumnarProto;
+
+#endif /* ACOLUMNAR_H_ */
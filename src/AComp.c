@@ -1,18 +1,192 @@
 #include <string.h>
 #include "AComp.h"
+#include "AInternal.h"
 
 int pointerComp(const void* a, const void* b);
 int intComp(const void* a, const void* b);
+int int64Comp(const void* a, const void* b);
+int astringComp(const void* a, const void* b);
 
-static const __AComp _AComp = { pointerComp, intComp, (AValueComp)strcmp };
+static AKeyComp describe(AValueComp comp);
+
+static const __AComp _AComp = { pointerComp, intComp, (AValueComp)strcmp, int64Comp, astringComp, describe };
 const __AComp* AComp = &_AComp;
 
+/*
+ * The comparisons don't subtract, so they can't overflow and always agree with
+ * the comparisons data structures do inline for the kinds of these functions
+ */
+
 int pointerComp(const void* a, const void* b)
 {
-	return (const char *)a - (const char *)b;
+	return ((const char *)a > (const char *)b) - ((const char *)a < (const char *)b);
 }
 
 int intComp(const void* a, const void* b)
 {
-	return *(const int *)a - *(const int *)b;
+	return (*(const int *)a > *(const int *)b) - (*(const int *)a < *(const int *)b);
+}
+
+int int64Comp(const void* a, const void* b)
+{
+	return (*(const long long *)a > *(const long long *)b) - (*(const long long *)a < *(const long long *)b);
+}
+
+int astringComp(const void* a, const void* b)
+{
+	return AStringCompare((const AString *)a, (const AString *)b);
+}
+
+static AKeyComp describe(AValueComp comp)
+{
+	AKeyComp desc;
+
+	desc.comp = comp;
+	desc.size = 0;
+
+	if (comp == pointerComp)
+	{
+		desc.kind = AKeyPointer;
+	}
+	else if (comp == intComp && sizeof(int) == 4)
+	{
+		desc.kind = AKeyInt32;
+	}
+	else if (comp == int64Comp)
+	{
+		desc.kind = AKeyInt64;
+	}
+	else if (comp == (AValueComp)strcmp)
+	{
+		desc.kind = AKeyString;
+	}
+	else if (comp == astringComp)
+	{
+		desc.kind = AKeyAString;
+	}
+	else
+	{
+		desc.kind = AKeyCustom;
+	}
+
+	return desc;
+}
+
+/*
+ * Sized strings are compared by finding the first mismatching byte
+ */
+
+#ifdef A_X86_SIMD
+
+/*
+ * Index of the first mismatching byte of 'size' bytes at 'a' and 'b' (or 'size' if they're equal),
+ * comparing 16 bytes at a time
+ */
+A_TARGET("sse2") static size_t mismatchSSE2(const unsigned char* a, const unsigned char* b, size_t size)
+{
+	size_t i;
+	unsigned mask;
+
+	for (i = 0; i + 16 <= size; i += 16)
+	{
+		mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(a + i)),
+		                                        _mm_loadu_si128((const __m128i *)(b + i))));
+
+		if (mask != 0xffff)
+		{
+			return i + ACountTrailingZeros(~mask);
+		}
+	}
+
+	if (i == size)
+	{
+		return size;
+	}
+
+	/* The bytes left are compared as the last 16 bytes, overlapping the ones which are known to be equal */
+	if (size >= 16)
+	{
+		mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(a + size - 16)),
+		                                        _mm_loadu_si128((const __m128i *)(b + size - 16))));
+
+		return mask != 0xffff ? size - 16 + ACountTrailingZeros(~mask) : size;
+	}
+
+	/* Shorter strings are copied to zeroed vectors, so the bytes after the end are equal */
+	{
+		unsigned char x[16] = { 0 }, y[16] = { 0 };
+
+		memcpy(x, a, size);
+		memcpy(y, b, size);
+		mask = _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)x),
+		                                        _mm_loadu_si128((const __m128i *)y)));
+
+		return mask != 0xffff ? ACountTrailingZeros(~mask) : size;
+	}
+}
+
+/*
+ * mismatchSSE2() 32 bytes at a time
+ */
+A_TARGET("avx2") static size_t mismatchAVX2(const unsigned char* a, const unsigned char* b, size_t size)
+{
+	size_t i;
+
+	for (i = 0; i + 32 <= size; i += 32)
+	{
+		unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(a + i)),
+		                                                                 _mm256_loadu_si256((const __m256i *)(b + i))));
+
+		if (mask != 0xffffffff)
+		{
+			return i + ACountTrailingZeros(~mask);
+		}
+	}
+
+	return i + mismatchSSE2(a + i, b + i, size - i);
+}
+
+#endif /* A_X86_SIMD */
+
+static size_t mismatch(const unsigned char* a, const unsigned char* b, size_t size)
+{
+	size_t i = 0;
+
+#ifdef A_X86_SIMD
+	if (A_CPU_SUPPORTS("avx2"))
+	{
+		return mismatchAVX2(a, b, size);
+	}
+
+	if (A_CPU_SUPPORTS("sse2"))
+	{
+		return mismatchSSE2(a, b, size);
+	}
+#endif
+
+	while (i < size && a[i] == b[i])
+	{
+		i++;
+	}
+
+	return i;
+}
+
+int AStringCompare(const AString* a, const AString* b)
+{
+	size_t size = a->length < b->length ? a->length : b->length;
+	size_t i = mismatch((const unsigned char *)a->data, (const unsigned char *)b->data, size);
+
+	if (i < size)
+	{
+		return (int)((const unsigned char *)a->data)[i] - (int)((const unsigned char *)b->data)[i];
+	}
+
+	return (a->length > b->length) - (a->length < b->length);
+}
+
+int AStringEqual(const AString* a, const AString* b)
+{
+	return a->length == b->length &&
+	       mismatch((const unsigned char *)a->data, (const unsigned char *)b->data, a->length) == a->length;
 }
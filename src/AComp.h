@@ -5,6 +5,9 @@
 #ifndef ACOMP_H_
 #define ACOMP_H_
 
+#include <stdlib.h>
+#include "AString.h"
+
 /**
  * Comparison function type.
  *
@@ -18,6 +21,35 @@
  */
 typedef int (*AValueComp)(const void *, const void *);
 
+/**
+ * Kinds of keys compared by comparison functions.
+ */
+typedef enum AKeyKind
+{
+	AKeyCustom,  /**< Keys only the comparison function knows how to compare */
+	AKeyInt32,   /**< Pointers to int */
+	AKeyInt64,   /**< Pointers to long long */
+	AKeyPointer, /**< The pointers themselves */
+	AKeyString,  /**< Pointers to null-terminated strings */
+	AKeyBytes,   /**< Pointers to a fixed number of bytes, compared like memcmp() */
+	AKeyAString  /**< Pointers to AString */
+} AKeyKind;
+
+/**
+ * Comparison function descriptor.
+ *
+ * Describes the kind of keys a comparison function compares. Data structures use the
+ * descriptor to compare keys of the built-in kinds inline, without calling the comparison
+ * function for each key. Get the descriptor of a comparison function using
+ * @link describe AComp->describe()@endlink, or fill it yourself for keys of AKeyBytes kind.
+ */
+typedef struct AKeyComp
+{
+	AKeyKind kind;   /**< The kind of the keys */
+	size_t size;     /**< Size of the keys in bytes (only for AKeyBytes) */
+	AValueComp comp; /**< The comparison function, which must agree with the kind */
+} AKeyComp;
+
 #ifdef DOXYGEN
 
 struct
@@ -25,6 +57,9 @@ struct
 	AValueComp pointerComp; /**< Pointer comparison function */
 	AValueComp intComp;     /**< Integer comparison function */
 	AValueComp stringComp;  /**< String comparison function  */
+	AValueComp int64Comp;   /**< 64 bit integer comparison function */
+	AValueComp astringComp; /**< AString comparison function */
+	AKeyComp (*const describe)(AValueComp comp); /**< Describe a comparison function */
 } *AComp;
 
 /**<
@@ -37,7 +72,12 @@ struct
  *
  * @link pointerComp AComp->pointerComp@endlink,
  * @link intComp AComp->intComp@endlink,
- * @link stringComp AComp->stringComp@endlink
+ * @link stringComp AComp->stringComp@endlink,
+ * @link int64Comp AComp->int64Comp@endlink,
+ * @link astringComp AComp->astringComp@endlink
+ *
+ * Data structures recognize these functions (using @link describe AComp->describe()@endlink)
+ * and compare keys inline instead of calling them.
  */
 
 /**
@@ -63,6 +103,31 @@ struct
  * This function is basically a pointer to strcmp().
  */
 
+/**
+ * @var AValueComp int64Comp
+ *
+ * Compare the 64 bit integers (long long) dereferenced by the pointers.
+ */
+
+/**
+ * @var AValueComp astringComp
+ *
+ * Compare the @link AString sized strings@endlink dereferenced by the pointers lexicographically
+ * with case-sensitivity (a string is less than the longer strings it's a prefix of). The characters
+ * are compared 16 or 32 at a time using SIMD instructions when the CPU supports them, and strings
+ * of different lengths are found unequal without comparing their characters when only equality
+ * matters (such as in AHashtable).
+ */
+
+/**
+ * @var AKeyComp (*describe)(AValueComp comp)
+ * @param comp Comparison function
+ * @return Descriptor of the comparison function
+ *
+ * Get the descriptor of a comparison function. The built-in comparison functions of
+ * AComp are described by their kinds, and any other function is of AKeyCustom kind.
+ */
+
 #endif
 
 typedef struct __AComp __AComp;
@@ -71,6 +136,9 @@ struct __AComp
 	AValueComp pointerComp;
 	AValueComp intComp;
 	AValueComp stringComp;
+	AValueComp int64Comp;
+	AValueComp astringComp;
+	AKeyComp (*const describe)(AValueComp comp);
 };
 
 extern const __AComp* AComp;
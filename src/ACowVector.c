@@ -0,0 +1,410 @@
+#include <stdlib.h>
+#include <string.h> /* for memcpy() */
+#include "AStructBase.h"
+#include "AInternal.h"
+#include "ACowVector.h"
+
+static ACowDirectory* ACowVectorNewDirectory(size_t capacity); /* Private functions */
+static void    ACowVectorReleaseChunk(ACowChunk* chunk);
+static void    ACowVectorReleaseSegment(ACowSegment* segment);
+static void    ACowVectorRelease(ACowDirectory* directory);
+static ACowDirectory* ACowVectorOwnDirectory(ACowVector* self);
+static ACowSegment* ACowVectorOwnSegment(ACowDirectory* directory, size_t index);
+static void**  ACowVectorOwnSlot(ACowVector* self, size_t pos);
+
+static void*   ACowVectorCreate(ACowVector* self, int numArgs, va_list args);
+static void    ACowVectorClear(ACowVector* self);
+static void    ACowVectorDestroy(ACowVector* self);
+static ACowVector* ACowVectorAppend(ACowVector* self, void* value);
+static void*   ACowVectorRemoveLast(ACowVector* self);
+static ACowVector* ACowVectorSet(ACowVector* self, size_t pos, void* value);
+static void*   ACowVectorGet(ACowVector* self, size_t pos);
+static ACowVector* ACowVectorSnapshot(ACowVector* self);
+
+const ACowVector ACowVectorProto =
+{
+	ACowVectorCreate, ACowVectorClear, ACowVectorDestroy, ACowVectorAppend, ACowVectorRemoveLast, ACowVectorSet,
+	ACowVectorGet, ACowVectorSnapshot
+};
+
+/*
+ * Create a new copy-on-write vector. The directory is allocated by the first change.
+ */
+static void* ACowVectorCreate(ACowVector* self, int numArgs, va_list args)
+{
+	self->directory = NULL;
+	self->size = 0;
+	self->immutable = 0;
+
+	return self;
+}
+
+/*
+ * Allocate a directory with room for 'capacity' segments, used by one vector
+ */
+static ACowDirectory* ACowVectorNewDirectory(size_t capacity)
+{
+	const size_t MIN_CAPACITY = 4;
+	ACowDirectory* directory = malloc(sizeof *directory);
+
+	if (directory == NULL)
+	{
+		return NULL;
+	}
+
+	directory->refs = 1;
+	directory->numSegments = 0;
+	directory->capacity = capacity < MIN_CAPACITY ? MIN_CAPACITY : capacity;
+
+	if ((directory->segments = malloc(directory->capacity * sizeof *directory->segments)) == NULL)
+	{
+		free(directory);
+		return NULL;
+	}
+
+	return directory;
+}
+
+/*
+ * Drop a reference to the chunk, and free it if it was the last one
+ */
+static void ACowVectorReleaseChunk(ACowChunk* chunk)
+{
+	if (AAtomicDecrement(&chunk->refs) == 0)
+	{
+		free(chunk);
+	}
+}
+
+/*
+ * Drop a reference to the segment, and free it (and drop its references to its chunks) if it was the last one
+ */
+static void ACowVectorReleaseSegment(ACowSegment* segment)
+{
+	size_t i;
+
+	if (AAtomicDecrement(&segment->refs) == 0)
+	{
+		for (i = 0; i < segment->numChunks; i++)
+		{
+			ACowVectorReleaseChunk(segment->chunks[i]);
+		}
+
+		free(segment);
+	}
+}
+
+/*
+ * Drop a reference to the directory, and free it (and drop its references to its segments) if it was the last one
+ */
+static void ACowVectorRelease(ACowDirectory* directory)
+{
+	size_t i;
+
+	if (directory != NULL && AAtomicDecrement(&directory->refs) == 0)
+	{
+		for (i = 0; i < directory->numSegments; i++)
+		{
+			ACowVectorReleaseSegment(directory->segments[i]);
+		}
+
+		free(directory->segments);
+		free(directory);
+	}
+}
+
+/*
+ * The directory of the vector, copied first if it's shared with snapshots. The copy shares the segments,
+ * so it costs one pointer per segment. References are only added through a vector or snapshot already using
+ * the directory, so a directory with a single reference is used by the vector alone (and the same goes for
+ * segments and the directories using them, and for chunks and the segments using them).
+ */
+static ACowDirectory* ACowVectorOwnDirectory(ACowVector* self)
+{
+	ACowDirectory* directory = self->directory;
+	ACowDirectory* copy;
+	size_t i;
+
+	if (directory == NULL)
+	{
+		return self->directory = ACowVectorNewDirectory(0);
+	}
+
+	if (AAtomicLoad(&directory->refs) == 1)
+	{
+		return directory;
+	}
+
+	if ((copy = ACowVectorNewDirectory(directory->numSegments)) == NULL)
+	{
+		return NULL;
+	}
+
+	for (i = 0; i < directory->numSegments; i++)
+	{
+		copy->segments[i] = directory->segments[i];
+		AAtomicIncrement(&copy->segments[i]->refs);
+	}
+
+	copy->numSegments = directory->numSegments;
+	ACowVectorRelease(directory);
+
+	return self->directory = copy;
+}
+
+/*
+ * The segment of the index, in a directory the vector owns, copied first if it's shared. The copy shares
+ * the chunks. The index may be the one of a new segment.
+ */
+static ACowSegment* ACowVectorOwnSegment(ACowDirectory* directory, size_t index)
+{
+	ACowSegment* segment;
+	size_t i;
+
+	if (index < directory->numSegments && AAtomicLoad(&directory->segments[index]->refs) == 1)
+	{
+		return directory->segments[index];
+	}
+
+	if (index == directory->numSegments && directory->numSegments == directory->capacity)
+	{
+		ACowSegment** newSegments = realloc(directory->segments, 2 * directory->capacity * sizeof *newSegments);
+
+		if (newSegments == NULL)
+		{
+			return NULL;
+		}
+
+		directory->segments = newSegments;
+		directory->capacity *= 2;
+	}
+
+	if ((segment = malloc(sizeof *segment)) == NULL)
+	{
+		return NULL;
+	}
+
+	segment->refs = 1;
+	segment->numChunks = 0;
+
+	if (index == directory->numSegments) /* A new segment */
+	{
+		directory->numSegments++;
+	}
+	else /* A shared segment */
+	{
+		segment->numChunks = directory->segments[index]->numChunks;
+
+		for (i = 0; i < segment->numChunks; i++)
+		{
+			segment->chunks[i] = directory->segments[index]->chunks[i];
+			AAtomicIncrement(&segment->chunks[i]->refs);
+		}
+
+		ACowVectorReleaseSegment(directory->segments[index]);
+	}
+
+	return directory->segments[index] = segment;
+}
+
+/*
+ * The slot of the position, in a chunk which isn't shared. The position may be the first one of a new chunk.
+ */
+static void** ACowVectorOwnSlot(ACowVector* self, size_t pos)
+{
+	ACowDirectory* directory = ACowVectorOwnDirectory(self);
+	size_t index = pos / ACOWVECTOR_CHUNK % ACOWVECTOR_SEGMENT;
+	ACowSegment* segment;
+	ACowChunk* chunk;
+
+	if (directory == NULL ||
+	    (segment = ACowVectorOwnSegment(directory, pos / ACOWVECTOR_CHUNK / ACOWVECTOR_SEGMENT)) == NULL)
+	{
+		return NULL;
+	}
+
+	if (index == segment->numChunks) /* A new chunk */
+	{
+		if ((chunk = malloc(sizeof *chunk)) == NULL)
+		{
+			return NULL;
+		}
+
+		chunk->refs = 1;
+		segment->chunks[segment->numChunks++] = chunk;
+	}
+	else if (AAtomicLoad(&segment->chunks[index]->refs) != 1) /* A shared chunk */
+	{
+		if ((chunk = malloc(sizeof *chunk)) == NULL)
+		{
+			return NULL;
+		}
+
+		chunk->refs = 1;
+		memcpy(chunk->values, segment->chunks[index]->values, sizeof chunk->values);
+		ACowVectorReleaseChunk(segment->chunks[index]);
+		segment->chunks[index] = chunk;
+	}
+
+	return &segment->chunks[index]->values[pos % ACOWVECTOR_CHUNK];
+}
+
+/**
+ * @fn void (*ACowVector::clear)(ACowVector* self)
+ * @param self The copy-on-write vector
+ *
+ * Remove all the values from the vector. The snapshots of the vector keep their values.
+ * Snapshots can't be cleared.
+ */
+static void ACowVectorClear(ACowVector* self)
+{
+	if (self != NULL && !self->immutable)
+	{
+		ACowVectorRelease(self->directory);
+		self->directory = NULL;
+		self->size = 0;
+	}
+}
+
+/**
+ * @fn void (*ACowVector::destroy)(ACowVector* self)
+ * @param self The copy-on-write vector or snapshot
+ *
+ * Destroy the vector or the snapshot. The directory, the segments and the chunks are freed once they're not used
+ * by any other vector or snapshot. Any access to a destroyed vector is forbidden.
+ */
+static void ACowVectorDestroy(ACowVector* self)
+{
+	if (self != NULL)
+	{
+		ACowVectorRelease(self->directory);
+		free(self);
+	}
+}
+
+/**
+ * @fn ACowVector* (*ACowVector::append)(ACowVector* self, void* value)
+ * @param self The copy-on-write vector
+ * @param value The value
+ * @return The vector or NULL on error
+ *
+ * Append a value to the end of the vector. Appending to a snapshot fails.
+ */
+static ACowVector* ACowVectorAppend(ACowVector* self, void* value)
+{
+	void** slot;
+
+	if (self == NULL || self->immutable || (slot = ACowVectorOwnSlot(self, self->size)) == NULL)
+	{
+		return NULL;
+	}
+
+	*slot = value;
+	self->size++;
+
+	return self;
+}
+
+/**
+ * @fn void* (*ACowVector::removeLast)(ACowVector* self)
+ * @param self The copy-on-write vector
+ * @return The last value or NULL on error
+ *
+ * Remove the last value of the vector. No chunk is copied. Removing from a snapshot fails.
+ */
+static void* ACowVectorRemoveLast(ACowVector* self)
+{
+	void* value;
+
+	if (self == NULL || self->immutable || self->size == 0)
+	{
+		return NULL;
+	}
+
+	value = ACowVectorGet(self, self->size - 1);
+	self->size--;
+
+	return value;
+}
+
+/**
+ * @fn ACowVector* (*ACowVector::set)(ACowVector* self, size_t pos, void* value)
+ * @param self The copy-on-write vector
+ * @param pos Position index
+ * @param value The value
+ * @return The vector or NULL on error
+ *
+ * Set the value at the position. If the segment or the chunk of the position is shared with a snapshot,
+ * it's copied first. If position equals self->size then the call would be equivalent to ACowVector::append().
+ * Setting a value of a snapshot fails.
+ */
+static ACowVector* ACowVectorSet(ACowVector* self, size_t pos, void* value)
+{
+	void** slot;
+
+	if (self == NULL || self->immutable || pos > self->size)
+	{
+		return NULL;
+	}
+
+	if (pos == self->size)
+	{
+		return ACowVectorAppend(self, value);
+	}
+
+	if ((slot = ACowVectorOwnSlot(self, pos)) == NULL)
+	{
+		return NULL;
+	}
+
+	*slot = value;
+	return self;
+}
+
+/**
+ * @fn void* (*ACowVector::get)(ACowVector* self, size_t pos)
+ * @param self The copy-on-write vector or snapshot
+ * @param pos Position index
+ * @return The value at the position or NULL on error
+ */
+static void* ACowVectorGet(ACowVector* self, size_t pos)
+{
+	if (self != NULL && pos < self->size)
+	{
+		size_t index = pos / ACOWVECTOR_CHUNK;
+
+		return self->directory->segments[index / ACOWVECTOR_SEGMENT]->chunks[index % ACOWVECTOR_SEGMENT]
+		           ->values[pos % ACOWVECTOR_CHUNK];
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn ACowVector* (*ACowVector::snapshot)(ACowVector* self)
+ * @param self The copy-on-write vector (or a snapshot of it)
+ * @return A new snapshot or NULL on error
+ *
+ * Create an immutable snapshot of the current values of the vector in O(1) time. The snapshot shares
+ * the values with the vector, and keeps them when the vector changes. Destroy it using ACowVector::destroy().
+ */
+static ACowVector* ACowVectorSnapshot(ACowVector* self)
+{
+	ACowVector* snapshot;
+
+	if (self == NULL || (snapshot = AStruct->ANew(ACowVector)) == NULL)
+	{
+		return NULL;
+	}
+
+	if (self->directory != NULL)
+	{
+		AAtomicIncrement(&self->directory->refs);
+	}
+
+	snapshot->directory = self->directory;
+	snapshot->size = self->size;
+	snapshot->immutable = 1;
+
+	return snapshot;
+}
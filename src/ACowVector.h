@@ -0,0 +1,111 @@
+/**
+ * @file ACowVector.h
+ */
+
+#ifndef ACOWVECTOR_H_
+#define ACOWVECTOR_H_
+
+#include <stdarg.h>
+#include "AStructBase.h"
+
+/**
+ * Number of values in each chunk of a @link ACowVector copy-on-write vector@endlink (a power of 2)
+ */
+#define ACOWVECTOR_CHUNK 64
+
+/**
+ * Number of chunks in each segment of the directory of a @link ACowVector copy-on-write vector@endlink
+ */
+#define ACOWVECTOR_SEGMENT 64
+
+typedef struct ACowChunk ACowChunk;
+typedef struct ACowSegment ACowSegment;
+typedef struct ACowDirectory ACowDirectory;
+
+/**
+ * Chunk of values of a @link ACowVector copy-on-write vector@endlink, shared by the segments which point to it
+ */
+struct ACowChunk
+{
+	long refs;                             /*<  Number of segments pointing to the chunk */
+	void* values[ACOWVECTOR_CHUNK];        /*<  The values */
+};
+
+/**
+ * Segment of the directory of a @link ACowVector copy-on-write vector@endlink, shared by the directories
+ * which point to it
+ */
+struct ACowSegment
+{
+	long refs;                             /*<  Number of directories pointing to the segment */
+	size_t numChunks;                      /*<  Number of chunks the segment points to */
+	ACowChunk* chunks[ACOWVECTOR_SEGMENT]; /*<  The chunks */
+};
+
+/**
+ * Directory of the chunks of a @link ACowVector copy-on-write vector@endlink, shared by the vector and its snapshots
+ */
+struct ACowDirectory
+{
+	long refs;                             /*<  Number of vectors and snapshots using the directory */
+	size_t numSegments;                    /*<  Number of segments the directory points to */
+	size_t capacity;                       /*<  The allocated number of segment pointers */
+	ACowSegment** segments;                /*<  The segments */
+};
+
+typedef struct ACowVector ACowVector;
+
+/**
+ * Copy-on-write vector with snapshots
+ *
+ * This data structure is a dynamic array like AVector, which can share its values with immutable snapshots
+ * of it. Use it to publish the values of a vector to reader threads while one writer thread keeps changing it.
+ *
+ * The values are stored in chunks of @ref ACOWVECTOR_CHUNK values. A directory of two levels points to the
+ * chunks: an array of segments, each pointing to up to @ref ACOWVECTOR_SEGMENT chunks. A snapshot shares the
+ * directory of the vector, so ACowVector::snapshot() takes O(1) time whatever the size of the vector. The first
+ * change of the vector after a snapshot was taken copies the array of segments (one pointer for every
+ * @ref ACOWVECTOR_SEGMENT * @ref ACOWVECTOR_CHUNK values), and every change copies the segment and the chunk
+ * it changes if they're shared: so a change costs at most one segment and one chunk, and the segments and
+ * chunks which aren't changed stay shared. The directory, the segments and the chunks are freed when the last
+ * vector or snapshot using them is destroyed, using atomic reference counts.
+ *
+ * Snapshots can't be changed, so threads can read them at the same time without locking. Each snapshot is
+ * destroyed on its own, by any thread. The vector and its snapshots must be changed (or snapshotted) by one
+ * thread at a time, and a snapshot must be handed over to other threads safely (for example, using a mutex
+ * or an atomic store with release semantics).
+ *
+ * The vector doesn't own its values: they're shared by the snapshots, so they're never freed by the vector.
+ *
+ * The arguments passed to @link ANew AStruct->ANew()@endlink to create a new copy-on-write vector are:
+ * @code AStruct->ANew(ACowVector) @endcode
+ * No additional arguments should be passed.
+ *
+ * Example of publishing a configuration table:
+ * @code
+ * ACowVector* table = AStruct->ANew(ACowVector);
+ * table->append(table, entry);
+ *
+ * ACowVector* published = table->snapshot(table); // Hand it over to the readers
+ * table->set(table, 0, newEntry);                 // The readers still see entry
+ * @endcode
+ */
+struct ACowVector
+{
+	void*       (*const create)(ACowVector* self, int numArgs, va_list args);  /*<  Default creator function called by AStruct->ANew() */
+	void        (*const clear)(ACowVector* self);                              /**< Clear all the vector */
+	void        (*const destroy)(ACowVector* self);                            /**< Destroy the vector or the snapshot */
+	ACowVector* (*const append)(ACowVector* self, void* value);                /**< Append a value to the end of the vector */
+	void*       (*const removeLast)(ACowVector* self);                         /**< Remove the last value of the vector */
+	ACowVector* (*const set)(ACowVector* self, size_t pos, void* value);       /**< Set a value at the position */
+	void*       (*const get)(ACowVector* self, size_t pos);                    /**< Get the value at the position */
+	ACowVector* (*const snapshot)(ACowVector* self);                           /**< Get an immutable snapshot of the vector */
+
+	ACowDirectory* directory; /*<  The directory of the chunks of values, possibly shared */
+	size_t size;              /**< Number of items in the vector */
+	int immutable;            /**< Non-zero if this is a snapshot */
+};
+
+extern const ACowVector ACowVectorProto;
+
+#endif /* ACOWVECTOR_H_ */
@@ -0,0 +1,395 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* for mremap() */
+#endif
+#include <stdlib.h>
+#include <string.h> /* for memcpy(), memset() */
+#include "AStructBase.h"
+#include "AInternal.h"
+#include "AFileVector.h"
+
+#ifdef A_MMAP
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
+static void*  AFileVectorOpen(AFileVector* self, const char* path, int mode, size_t elementSize); /* Private functions */
+static void*  AFileVectorMap(AFileVector* self, size_t bytes);
+static void*  AFileVectorGrow(AFileVector* self, size_t size);
+static void   AFileVectorClose(AFileVector* self);
+
+static void*  AFileVectorCreate(AFileVector* self, int numArgs, va_list args);
+static void   AFileVectorClear(AFileVector* self);
+static void   AFileVectorDestroy(AFileVector* self);
+static void*  AFileVectorAppend(AFileVector* self, const void* element);
+static void*  AFileVectorSet(AFileVector* self, size_t pos, const void* element);
+static void*  AFileVectorGet(AFileVector* self, size_t pos);
+static AFileVector* AFileVectorReserve(AFileVector* self, size_t capacity);
+static AFileVector* AFileVectorSync(AFileVector* self);
+
+const AFileVector AFileVectorProto =
+{
+	AFileVectorCreate, AFileVectorClear, AFileVectorDestroy, AFileVectorAppend, AFileVectorSet, AFileVectorGet,
+	AFileVectorReserve, AFileVectorSync
+};
+
+static const char MAGIC[8] = { 'A', 'F', 'V', 'E', 'C', 'T', 'O', 'R' };
+
+/* Address of the element at position 'pos' of the file vector 'self' */
+#define elementAt(self, pos) ((char *)(self)->elements + (pos) * (self)->elementSize)
+
+/* Size in bytes of a file of 'capacity' elements */
+#define fileSize(self, capacity) (sizeof(AFileVectorHeader) + (capacity) * (self)->elementSize)
+
+/*
+ * Create a new file vector
+ */
+static void* AFileVectorCreate(AFileVector* self, int numArgs, va_list args)
+{
+	const char* path;
+	int mode, elementSize = 0;
+
+	/* Missing arguments */
+	if (numArgs < 2)
+	{
+		free(self);
+		return NULL;
+	}
+
+	path = va_arg(args, const char*);
+	mode = va_arg(args, int);
+
+	if (numArgs >= 3)
+	{
+		elementSize = va_arg(args, int);
+	}
+
+	if (path == NULL || mode < AFILEVECTOR_READ || mode > AFILEVECTOR_CREATE || elementSize < 0 ||
+	    AFileVectorOpen(self, path, mode, (size_t)elementSize) == NULL)
+	{
+		free(self);
+		return NULL;
+	}
+
+	return self;
+}
+
+/*
+ * Open or create the file, map it and check its header
+ */
+static void* AFileVectorOpen(AFileVector* self, const char* path, int mode, size_t elementSize)
+{
+#ifdef A_MMAP
+	AFileVectorHeader* header;
+	struct stat st;
+	int flags = mode == AFILEVECTOR_READ ? O_RDONLY : mode == AFILEVECTOR_WRITE ? O_RDWR | O_CREAT : O_RDWR | O_CREAT | O_TRUNC;
+
+	self->writable = mode != AFILEVECTOR_READ;
+	self->mapped = 0;
+
+	if ((self->fd = open(path, flags, 0666)) < 0)
+	{
+		return NULL;
+	}
+
+	if (fstat(self->fd, &st) != 0)
+	{
+		close(self->fd);
+		return NULL;
+	}
+
+	if (st.st_size == 0 && self->writable) /* A new file */
+	{
+		self->elementSize = elementSize;
+
+		if (elementSize == 0 || ftruncate(self->fd, (off_t)fileSize(self, 0)) != 0 ||
+		    (header = AFileVectorMap(self, fileSize(self, 0))) == NULL)
+		{
+			close(self->fd);
+			return NULL;
+		}
+
+		memset(header, 0, sizeof *header);
+		memcpy(header->magic, MAGIC, sizeof MAGIC);
+		header->version = AFILEVECTOR_VERSION;
+		header->elementSize = (unsigned)elementSize;
+		header->count = 0;
+		self->size = 0;
+
+		return self;
+	}
+
+	self->elementSize = 1; /* Until the header is read */
+
+	if ((size_t)st.st_size < sizeof *header || (header = AFileVectorMap(self, (size_t)st.st_size)) == NULL)
+	{
+		close(self->fd);
+		return NULL;
+	}
+
+	if (memcmp(header->magic, MAGIC, sizeof MAGIC) != 0 || header->version != AFILEVECTOR_VERSION ||
+	    header->elementSize == 0 || (elementSize > 0 && header->elementSize != elementSize))
+	{
+		munmap(header, self->mapped);
+		close(self->fd);
+		return NULL;
+	}
+
+	self->elementSize = header->elementSize;
+	self->capacity = ((size_t)st.st_size - sizeof *header) / self->elementSize;
+
+	if (header->count > self->capacity) /* The file was cut */
+	{
+		munmap(header, self->mapped);
+		close(self->fd);
+		return NULL;
+	}
+
+	self->size = (size_t)header->count;
+	return self;
+#else
+	(void)self, (void)path, (void)mode, (void)elementSize;
+	return NULL;
+#endif
+}
+
+/*
+ * Map 'bytes' bytes of the file (which is at least as large), replacing the current mapping.
+ * A mapping is resized by remapping it where the system can, so it doesn't need to be unmapped first.
+ */
+static void* AFileVectorMap(AFileVector* self, size_t bytes)
+{
+#ifdef A_MMAP
+	int prot = self->writable ? PROT_READ | PROT_WRITE : PROT_READ;
+	void* mapping;
+
+#ifdef A_MREMAP
+	if (self->mapped > 0)
+	{
+		mapping = mremap(self->header, self->mapped, bytes, MREMAP_MAYMOVE);
+	}
+	else
+#endif
+	{
+		mapping = mmap(NULL, bytes, prot, MAP_SHARED, self->fd, 0);
+
+		if (mapping != MAP_FAILED && self->mapped > 0)
+		{
+			munmap(self->header, self->mapped);
+		}
+	}
+
+	if (mapping == MAP_FAILED)
+	{
+		return NULL;
+	}
+
+	self->mapped = bytes;
+	self->header = mapping;
+	self->elements = self->header + 1;
+	self->capacity = (bytes - sizeof *self->header) / self->elementSize;
+
+	return mapping;
+#else
+	(void)self, (void)bytes;
+	return NULL;
+#endif
+}
+
+/*
+ * Expand the file so it can hold 'size' elements
+ */
+static void* AFileVectorGrow(AFileVector* self, size_t size)
+{
+	const size_t MIN_CAPACITY = 16;
+	size_t newCapacity = self->capacity;
+
+	if (!self->writable)
+	{
+		return NULL;
+	}
+
+	if (size > newCapacity)
+	{
+		newCapacity = newCapacity < MIN_CAPACITY ? MIN_CAPACITY : newCapacity;
+
+		while (size > newCapacity)
+		{
+			newCapacity *= 2;
+		}
+
+#ifdef A_MMAP
+		if (ftruncate(self->fd, (off_t)fileSize(self, newCapacity)) != 0)
+		{
+			return NULL;
+		}
+#endif
+
+		if (AFileVectorMap(self, fileSize(self, newCapacity)) == NULL)
+		{
+			return NULL;
+		}
+	}
+
+	return self->elements;
+}
+
+/*
+ * Unmap the file, cut it to the size of its elements and close it
+ */
+static void AFileVectorClose(AFileVector* self)
+{
+#ifdef A_MMAP
+	munmap(self->header, self->mapped);
+
+	if (self->writable && ftruncate(self->fd, (off_t)fileSize(self, self->size)) != 0)
+	{
+		/* The file just keeps its spare capacity, which is ignored when it's opened */
+	}
+
+	close(self->fd);
+#else
+	(void)self;
+#endif
+}
+
+/**
+ * @fn void (*AFileVector::clear)(AFileVector* self)
+ * @param self The file vector
+ *
+ * Remove all the elements from the file. Nothing is removed from a file opened for reading only.
+ */
+static void AFileVectorClear(AFileVector* self)
+{
+	if (self != NULL && self->writable)
+	{
+		self->size = 0;
+		self->header->count = 0;
+	}
+}
+
+/**
+ * @fn void (*AFileVector::destroy)(AFileVector* self)
+ * @param self The file vector
+ *
+ * Unmap and close the file, and cut it to the size of its elements. The elements which were changed are
+ * written to the file by the system even if it's not synced. Any access to a destroyed file vector is forbidden.
+ */
+static void AFileVectorDestroy(AFileVector* self)
+{
+	if (self != NULL)
+	{
+		AFileVectorClose(self);
+		free(self);
+	}
+}
+
+/**
+ * @fn void* (*AFileVector::append)(AFileVector* self, const void* element)
+ * @param self The file vector
+ * @param element Pointer to the element to copy
+ * @return Pointer to the element in the file or NULL on error
+ *
+ * Append an element to the end of the file. Appending to a file opened for reading only fails.
+ */
+static void* AFileVectorAppend(AFileVector* self, const void* element)
+{
+	if (self != NULL && AFileVectorGrow(self, self->size + 1) != NULL)
+	{
+		memcpy(elementAt(self, self->size), element, self->elementSize);
+		self->header->count = ++self->size;
+
+		return elementAt(self, self->size - 1);
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn void* (*AFileVector::set)(AFileVector* self, size_t pos, const void* element)
+ * @param self The file vector
+ * @param pos Position index
+ * @param element Pointer to the element to copy
+ * @return Pointer to the element in the file or NULL on error
+ *
+ * Set the element at the position. If position equals self->size then
+ * the call would be equivalent to AFileVector::append(). Setting an element
+ * of a file opened for reading only fails.
+ */
+static void* AFileVectorSet(AFileVector* self, size_t pos, const void* element)
+{
+	if (self != NULL && self->writable)
+	{
+		if (pos == self->size)
+		{
+			return AFileVectorAppend(self, element);
+		}
+
+		if (pos < self->size)
+		{
+			return memcpy(elementAt(self, pos), element, self->elementSize);
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn void* (*AFileVector::get)(AFileVector* self, size_t pos)
+ * @param self The file vector
+ * @param pos Position index
+ * @return Pointer to the element at the position or NULL on error
+ *
+ * The element is part of the mapped file: writing it changes the file, which
+ * is forbidden unless the file was opened for writing.
+ */
+static void* AFileVectorGet(AFileVector* self, size_t pos)
+{
+	if (self != NULL && pos < self->size)
+	{
+		return elementAt(self, pos);
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn AFileVector* (*AFileVector::reserve)(AFileVector* self, size_t capacity)
+ * @param self The file vector
+ * @param capacity Number of elements
+ * @return The file vector or NULL on error
+ *
+ * Make sure the file can hold capacity elements without expanding.
+ */
+static AFileVector* AFileVectorReserve(AFileVector* self, size_t capacity)
+{
+	if (self != NULL && (capacity <= self->capacity || AFileVectorGrow(self, capacity) != NULL))
+	{
+		return self;
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn AFileVector* (*AFileVector::sync)(AFileVector* self)
+ * @param self The file vector
+ * @return The file vector or NULL on error
+ *
+ * Write the changed elements and the header to the file, and wait until they're written.
+ */
+static AFileVector* AFileVectorSync(AFileVector* self)
+{
+	if (self == NULL)
+	{
+		return NULL;
+	}
+
+#ifdef A_MMAP
+	if (self->writable && msync(self->header, self->mapped, MS_SYNC) != 0)
+	{
+		return NULL;
+	}
+#endif
+
+	return self;
+}
@@ -0,0 +1,98 @@
+/**
+ * @file AFileVector.h
+ */
+
+#ifndef AFILEVECTOR_H_
+#define AFILEVECTOR_H_
+
+#include <stdarg.h>
+#include "AStructBase.h"
+
+/** Open an existing file for reading only */
+#define AFILEVECTOR_READ 0
+/** Open an existing file for reading and writing, or create it if it doesn't exist */
+#define AFILEVECTOR_WRITE 1
+/** Create a new file for reading and writing, replacing the file if it exists */
+#define AFILEVECTOR_CREATE 2
+
+/** Version of the file format written to new files */
+#define AFILEVECTOR_VERSION 1
+
+/**
+ * Header of a file vector file
+ *
+ * The file starts with this header, followed by the elements one after the other. All the fields are
+ * in the byte order of the machine which wrote the file. The elements start 64 bytes into the file.
+ */
+typedef struct AFileVectorHeader
+{
+	char magic[8];              /**< "AFVECTOR" */
+	unsigned version;           /**< Version of the file format */
+	unsigned elementSize;       /**< Size of each element in bytes */
+	unsigned long long count;   /**< Number of elements in the file */
+	unsigned char reserved[40]; /*<  Zeros, for later versions */
+} AFileVectorHeader;
+
+typedef struct AFileVector AFileVector;
+
+/**
+ * Memory-mapped file of fixed-size elements
+ *
+ * This data structure is an array of fixed-size elements like AArray, which is stored in a file.
+ * The file is mapped into memory, so opening it doesn't read or parse the elements: they're loaded
+ * by the system when they're first accessed, and elements which were changed are written back to the
+ * file by the system too. Use it to persist arrays of numbers or flat structs (without pointers), and
+ * to load them at once.
+ *
+ * Elements are appended to the end of the file, and the file grows (geometrically) as needed. The file
+ * is cut to the size of its elements when the file vector is destroyed. Pointers to elements are valid
+ * until the file vector grows or is destroyed.
+ *
+ * AFileVector is POSIX-only. The Visual Studio project doesn't build it, and where the system
+ * has no memory-mapped files (such as MinGW), creating a file vector fails.
+ *
+ * The arguments passed to @link ANew AStruct->ANew()@endlink to create a new file vector are:
+ * @code AStruct->ANew(AFileVector, const char* path, int mode, int elementSize)@endcode
+ * @param path Path of the file
+ * @param mode @ref AFILEVECTOR_READ, @ref AFILEVECTOR_WRITE or @ref AFILEVECTOR_CREATE
+ * @param [opt]elementSize Size of each element in bytes. Required to create a new file. If it's
+ * given for an existing file, opening the file fails unless it has elements of the same size.
+ *
+ * Examples of creating a new file vector:
+ * @code
+ * struct Point { double x, y; };
+ * struct Point p = { 1.0, 2.0 };
+ *
+ * AFileVector* points = AStruct->ANew(AFileVector, "points.dat", AFILEVECTOR_CREATE, sizeof(struct Point));
+ * points->append(points, &p);
+ * points->destroy(points);
+ *
+ * // Map the file again, for reading only
+ * points = AStruct->ANew(AFileVector, "points.dat", AFILEVECTOR_READ, sizeof(struct Point));
+ * ((struct Point *)points->get(points, 0))->x == 1.0;
+ * @endcode
+ */
+struct AFileVector
+{
+	void*  (*const create)(AFileVector* self, int numArgs, va_list args);        /*<  Default creator function called by AStruct->ANew() */
+	void   (*const clear)(AFileVector* self);                                    /**< Clear all the file vector */
+	void   (*const destroy)(AFileVector* self);                                  /**< Close the file and destroy the file vector */
+	void*  (*const append)(AFileVector* self, const void* element);              /**< Append an element to the end of the file */
+	void*  (*const set)(AFileVector* self, size_t pos, const void* element);     /**< Set the element at the position */
+	void*  (*const get)(AFileVector* self, size_t pos);                          /**< Get the element at the position */
+	AFileVector* (*const reserve)(AFileVector* self, size_t capacity);           /**< Reserve capacity for a number of elements */
+	AFileVector* (*const sync)(AFileVector* self);                               /**< Write the changes to the file */
+
+	void* elements;              /**< The elements, one after the other */
+	size_t elementSize;          /**< Size of each element in bytes */
+	size_t size;                 /**< Number of elements in the file vector */
+	size_t capacity;             /*<  Number of elements the file has room for */
+	int writable;                /**< Non-zero if the file was opened for writing */
+	int fd;                      /*<  File descriptor of the file */
+	AFileVectorHeader* header;   /*<  The header, at the start of the mapping */
+	size_t mapped;               /*<  Size in bytes of the mapping (and the file) */
+};
+
+extern const AFileVector AFileVectorProto;
+
+#endif /* AFILEVECTOR_H_ */
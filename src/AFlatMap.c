@@ -0,0 +1,431 @@
+#include <stdlib.h>
+#include "AStructBase.h"
+#include "AInternal.h"
+#include "AFlatMap.h"
+
+static size_t   AFlatMapLowerBound(AFlatMap* self, const void* key); /* Private functions */
+static void     AFlatMapKeyComp(AFlatMap* self);
+static void     AFlatMapReplace(AFlatMap* self, APair* pair, void* key, void* value);
+static void     AFlatMapFreePair(AFlatMap* self, APair* pair);
+
+static void*    AFlatMapCreate(AFlatMap* self, int numArgs, va_list args);
+static void     AFlatMapClear(AFlatMap* self);
+static void     AFlatMapDestroy(AFlatMap* self);
+static APair*   AFlatMapSet(AFlatMap* self, void* key, void* value);
+static void*    AFlatMapGet(AFlatMap* self, const void* key);
+static void     AFlatMapRemove(AFlatMap* self, const void* key);
+static APair**  AFlatMapRange(AFlatMap* self, const void* from, const void* to, size_t* count);
+static AFlatMap* AFlatMapMerge(AFlatMap* self, const APair* pairs, size_t count);
+static void*    AFlatMapTraverse(AFlatMap* self, AFlatMapTraverseFunc func);
+
+const AFlatMap AFlatMapProto =
+{
+	AFlatMapCreate, AFlatMapClear, AFlatMapDestroy, AFlatMapSet, AFlatMapGet, AFlatMapRemove,
+	AFlatMapRange, AFlatMapMerge, AFlatMapTraverse
+};
+
+/* The pairs of the map */
+#define pairsOf(self) ((APair **)(self)->pairs->values)
+
+/* Compare the keys a and b of the map (see AKeysCompare()) */
+#define compareKeys(self, a, b) AKeysCompare(&(self)->keyComp, (self)->keyComp.kind, a, b)
+
+/*
+ * Describe the comparison function of the map again if AFlatMap::comp was replaced after
+ * AFlatMap::keyComp was made
+ */
+static void AFlatMapKeyComp(AFlatMap* self)
+{
+	if (self->keyComp.comp != self->comp)
+	{
+		self->keyComp = AComp->describe(self->comp);
+	}
+}
+
+/*
+ * Create a new AFlatMap
+ */
+static void* AFlatMapCreate(AFlatMap* self, int numArgs, va_list args)
+{
+	int capacity = 0;
+
+	/* Missing arguments */
+	if (numArgs < 1)
+	{
+		free(self);
+		return NULL;
+	}
+
+	self->comp = va_arg(args, AValueComp);
+	self->keyComp = AComp->describe(self->comp);
+	self->freeKey = NULL;
+	self->freeValue = NULL;
+
+	if (numArgs >= 3) /* key and value destructors */
+	{
+		self->freeKey = va_arg(args, AValueFree);
+		self->freeValue = va_arg(args, AValueFree);
+	}
+
+	if (numArgs >= 4)
+	{
+		capacity = va_arg(args, int);
+	}
+
+	if ((self->pairs = capacity > 0 ? AStruct->ANew(AVector, capacity) : AStruct->ANew(AVector)) == NULL)
+	{
+		free(self);
+		return NULL;
+	}
+
+	self->size = 0;
+	return self;
+}
+
+/*
+ * Position of the first pair whose key isn't less than the key (branchless, like AVector::lowerBound()),
+ * comparing keys of kind 'kind'
+ */
+static A_INLINE size_t AFlatMapLowerBoundKind(AFlatMap* self, const void* key, AKeyKind kind)
+{
+	APair** pairs = pairsOf(self);
+	APair** base = pairs;
+	size_t size, half;
+
+	for (size = self->size; size > 1; size -= half)
+	{
+		half = size / 2;
+		base = AKeysCompare(&self->keyComp, kind, base[half]->key, key) < 0 ? base + half : base;
+	}
+
+	return (base - pairs) + (AKeysCompare(&self->keyComp, kind, (*base)->key, key) < 0);
+}
+
+/*
+ * Position of the first pair whose key isn't less than the key (see AFlatMapLowerBoundKind()).
+ * The built-in kinds of keys get their own loop, so keys are compared inline.
+ */
+static size_t AFlatMapLowerBound(AFlatMap* self, const void* key)
+{
+	AFlatMapKeyComp(self);
+
+	if (self->size == 0)
+	{
+		return 0;
+	}
+
+	switch (self->keyComp.kind)
+	{
+		case AKeyInt32:   return AFlatMapLowerBoundKind(self, key, AKeyInt32);
+		case AKeyInt64:   return AFlatMapLowerBoundKind(self, key, AKeyInt64);
+		case AKeyPointer: return AFlatMapLowerBoundKind(self, key, AKeyPointer);
+		case AKeyString:  return AFlatMapLowerBoundKind(self, key, AKeyString);
+		case AKeyBytes:   return AFlatMapLowerBoundKind(self, key, AKeyBytes);
+		case AKeyAString: return AFlatMapLowerBoundKind(self, key, AKeyAString);
+		default:          return AFlatMapLowerBoundKind(self, key, AKeyCustom);
+	}
+}
+
+/*
+ * Replace the key and the value of the pair, and free the old ones if they're replaced by others
+ */
+static void AFlatMapReplace(AFlatMap* self, APair* pair, void* key, void* value)
+{
+	if (self->freeKey != NULL && pair->key != key)
+	{
+		self->freeKey(pair->key);
+	}
+
+	if (self->freeValue != NULL && pair->value != value)
+	{
+		self->freeValue(pair->value);
+	}
+
+	pair->key = key;
+	pair->value = value;
+}
+
+static void AFlatMapFreePair(AFlatMap* self, APair* pair)
+{
+	if (self->freeKey != NULL)
+	{
+		self->freeKey(pair->key);
+	}
+
+	if (self->freeValue != NULL)
+	{
+		self->freeValue(pair->value);
+	}
+
+	free(pair);
+}
+
+/**
+ * @fn void (*AFlatMap::clear)(AFlatMap* self)
+ * @param self The flat map
+ *
+ * Clear the map by removing all the keys and values using @link AFlatMap::freeKey self->freeKey@endlink
+ * and @link AFlatMap::freeValue self->freeValue@endlink (if they're not NULL).
+ */
+static void AFlatMapClear(AFlatMap* self)
+{
+	size_t i;
+
+	for (i = 0; i < self->size; i++)
+	{
+		AFlatMapFreePair(self, pairsOf(self)[i]);
+	}
+
+	self->pairs->eraseRange(self->pairs, 0, self->size, NULL);
+	self->size = 0;
+}
+
+/**
+ * @fn void (*AFlatMap::destroy)(AFlatMap* self)
+ * @param self The flat map
+ *
+ * @link AFlatMap::clear() Clear@endlink the map and free all of
+ * its storage. Any access to a destroyed map is forbidden.
+ */
+static void AFlatMapDestroy(AFlatMap* self)
+{
+	AFlatMapClear(self);
+	self->pairs->destroy(self->pairs, NULL);
+	free(self);
+}
+
+/**
+ * @fn APair* (*AFlatMap::set)(AFlatMap* self, void* key, void* value)
+ * @param self The flat map
+ * @param key The key
+ * @param value The value
+ * @return A key-value pair or NULL on error
+ *
+ * Maps the value to the key. If the same key was inserted before,
+ * it and the previous value will be removed using @link AFlatMap::freeKey self->freeKey@endlink
+ * and @link AFlatMap::freeValue self->freeValue@endlink (if they're not NULL). A new key
+ * moves the pairs of the keys after it.
+ */
+static APair* AFlatMapSet(AFlatMap* self, void* key, void* value)
+{
+	size_t pos = AFlatMapLowerBound(self, key);
+	APair* pair;
+
+	if (pos < self->size && compareKeys(self, pairsOf(self)[pos]->key, key) == 0)
+	{
+		pair = pairsOf(self)[pos];
+		AFlatMapReplace(self, pair, key, value);
+		return pair;
+	}
+
+	if ((pair = malloc(sizeof *pair)) == NULL)
+	{
+		return NULL;
+	}
+
+	pair->key = key;
+	pair->value = value;
+
+	if (self->pairs->insert(self->pairs, pos, pair) == NULL)
+	{
+		free(pair);
+		return NULL;
+	}
+
+	self->size++;
+	return pair;
+}
+
+/**
+ * @fn void* (*AFlatMap::get)(AFlatMap* self, const void* key)
+ * @param self The flat map
+ * @param key The key
+ * @return The value or NULL if there's no such key
+ *
+ * Get the value of a key in O(log n) time.
+ */
+static void* AFlatMapGet(AFlatMap* self, const void* key)
+{
+	size_t pos = AFlatMapLowerBound(self, key);
+
+	if (pos < self->size && compareKeys(self, pairsOf(self)[pos]->key, key) == 0)
+	{
+		return pairsOf(self)[pos]->value;
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn void (*AFlatMap::remove)(AFlatMap* self, const void* key)
+ * @param self The flat map
+ * @param key The key
+ *
+ * Remove the key and its value from the map and free them using @link AFlatMap::freeKey self->freeKey@endlink
+ * and @link AFlatMap::freeValue self->freeValue@endlink (if they're not NULL). The pairs of the keys
+ * after it are moved.
+ */
+static void AFlatMapRemove(AFlatMap* self, const void* key)
+{
+	size_t pos = AFlatMapLowerBound(self, key);
+
+	if (pos < self->size && compareKeys(self, pairsOf(self)[pos]->key, key) == 0)
+	{
+		AFlatMapFreePair(self, self->pairs->remove(self->pairs, pos));
+		self->size--;
+	}
+}
+
+/**
+ * @fn APair** (*AFlatMap::range)(AFlatMap* self, const void* from, const void* to, size_t* count)
+ * @param self The flat map
+ * @param from The first key of the range
+ * @param to The key after the range
+ * @param count Pointer to store the number of entries in the range to
+ * @return Array of the entries whose keys are from from and less than to, in key order
+ *
+ * Get the entries of a range of keys in O(log n) time. The array is part of
+ * the map, so it's valid only until the map is changed.
+ */
+static APair** AFlatMapRange(AFlatMap* self, const void* from, const void* to, size_t* count)
+{
+	size_t first = AFlatMapLowerBound(self, from);
+	size_t last = AFlatMapLowerBound(self, to);
+
+	*count = last > first ? last - first : 0;
+	return pairsOf(self) + first;
+}
+
+/**
+ * @fn AFlatMap* (*AFlatMap::merge)(AFlatMap* self, const APair* pairs, size_t count)
+ * @param self The flat map
+ * @param pairs Array of key-value pairs, sorted by their keys
+ * @param count Number of pairs in the array
+ * @return The map or NULL on error
+ *
+ * Set the values of all the keys of the array, like AFlatMap::set() does for each of them
+ * (later pairs of the same key replace earlier ones). When the array is sorted, the map and
+ * the array are merged in one pass taking O(n + count) time, instead of moving the pairs of
+ * the map for each new key, and the map isn't changed on error. An unsorted array is set one
+ * pair at a time.
+ */
+static AFlatMap* AFlatMapMerge(AFlatMap* self, const APair* pairs, size_t count)
+{
+	AVector* merged;
+	APair** newPairs;
+	APair** old = pairsOf(self);
+	APair* last;
+	size_t i, j, k;
+
+	AFlatMapKeyComp(self);
+
+	for (j = 1; j < count; j++)
+	{
+		if (compareKeys(self, pairs[j - 1].key, pairs[j].key) > 0) /* Not sorted */
+		{
+			for (j = 0; j < count; j++)
+			{
+				if (AFlatMapSet(self, pairs[j].key, pairs[j].value) == NULL)
+				{
+					return NULL;
+				}
+			}
+
+			return self;
+		}
+	}
+
+	/* Allocate everything before changing anything, so a failure leaves the map as it was */
+	merged = AStruct->ANew(AVector);
+	newPairs = malloc(count * sizeof *newPairs);
+
+	if (merged == NULL || newPairs == NULL || merged->reserve(merged, self->size + count) == NULL)
+	{
+		if (merged != NULL)
+		{
+			merged->destroy(merged, NULL);
+		}
+
+		free(newPairs);
+		return NULL;
+	}
+
+	for (k = 0; k < count && (newPairs[k] = malloc(sizeof **newPairs)) != NULL; k++);
+
+	if (k < count)
+	{
+		while (k > 0)
+		{
+			free(newPairs[--k]);
+		}
+
+		merged->destroy(merged, NULL);
+		free(newPairs);
+		return NULL;
+	}
+
+	for (i = 0, j = 0, k = 0; i < self->size || j < count; )
+	{
+		if (j == count || (i < self->size && compareKeys(self, old[i]->key, pairs[j].key) < 0))
+		{
+			merged->append(merged, old[i++]);
+			continue;
+		}
+
+		last = merged->size > 0 ? merged->values[merged->size - 1] : NULL;
+
+		if (last != NULL && compareKeys(self, last->key, pairs[j].key) == 0) /* The same key again */
+		{
+			AFlatMapReplace(self, last, pairs[j].key, pairs[j].value);
+		}
+		else if (i < self->size && compareKeys(self, old[i]->key, pairs[j].key) == 0)
+		{
+			AFlatMapReplace(self, old[i], pairs[j].key, pairs[j].value);
+			merged->append(merged, old[i++]);
+		}
+		else
+		{
+			*newPairs[k] = pairs[j];
+			merged->append(merged, newPairs[k++]);
+		}
+
+		j++;
+	}
+
+	while (k < count) /* Pairs left for keys which were set already */
+	{
+		free(newPairs[k++]);
+	}
+
+	free(newPairs);
+	self->pairs->destroy(self->pairs, NULL);
+	self->pairs = merged;
+	self->size = merged->size;
+
+	return self;
+}
+
+/**
+ * @fn void* (*AFlatMap::traverse)(AFlatMap* self, AFlatMapTraverseFunc func)
+ * @param self The flat map
+ * @param func The function to apply to each key-value pair
+ * @return NULL in case of success, anything else in case of failure.
+ *
+ * Call func for each key-value pair in the map, in key order.
+ */
+static void* AFlatMapTraverse(AFlatMap* self, AFlatMapTraverseFunc func)
+{
+	size_t i;
+
+	for (i = 0; i < self->size; i++)
+	{
+		void* ret = func(pairsOf(self)[i]);
+
+		if (ret != NULL)
+		{
+			return ret;
+		}
+	}
+
+	return NULL;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file AFlatMap.h
+ */
+
+#ifndef AFLATMAP_H_
+#define AFLATMAP_H_
+
+#include <stdarg.h>
+#include "AStructBase.h"
+#include "APair.h"
+#include "AComp.h"
+#include "AVector.h"
+
+/**
+ * Flat map traversal function.
+ * @param pair A key-value pair
+ * @return NULL in case of success or anything else in case of failure.
+ *
+ * This function is callbacked by AFlatMap::traverse.
+ */
+typedef void* (*AFlatMapTraverseFunc)(APair* pair);
+
+typedef struct AFlatMap AFlatMap;
+
+/**
+ * Ordered flat map
+ *
+ * This data structure is a generic map of keys to values, ordered by the keys. The key-value pairs are
+ * kept in a vector sorted by their keys, and keys are found using binary search. Use it when you need the
+ * keys in order (or ranges of them), and you look keys up much more often than you add or remove them:
+ * lookups and traversals read consecutive memory, but adding or removing a key moves the pairs after it.
+ * Many keys are added at once with AFlatMap::merge().
+ *
+ * The arguments passed to @link ANew AStruct->ANew()@endlink to create a new flat map are:
+ * @code AStruct->ANew(AFlatMap, AValueComp comp, AValueFree freeKey, AValueFree freeValue, int capacity)@endcode
+ * @param comp Comparison function to order the keys. You can (and should) use the functions provided by ::AComp.
+ * @param [opt]freeKey Optional callback function to free the key. NULL by default.
+ * @param [opt]freeValue Optional callback function to free the value. NULL by default.
+ * @param [opt]capacity Optional argument to specify the initial capacity of the map.
+ *
+ * Examples of creating a new flat map:
+ * @code
+ * // Create a new flat map using strings as keys. Use free to free the keys and values.
+ * AFlatMap* map = AStruct->ANew(AFlatMap, AComp->stringComp, free, free);
+ *
+ * // Create a new flat map with initial capacity of 1000 items using ints as keys. Nothing will be freed.
+ * AFlatMap* map = AStruct->ANew(AFlatMap, AComp->intComp, NULL, NULL, 1000);
+ * @endcode
+ *
+ * Keys compared by the comparison functions of ::AComp are compared inline, without calling
+ * the function for each key the binary search visits.
+ */
+struct AFlatMap
+{
+	void*   (*const create)(AFlatMap* self, int numArgs, va_list args);    /*<  Default creator function called by AStruct->ANew() */
+	void    (*const clear)(AFlatMap* self);                                /**< Clear all the entries in the map */
+	void    (*const destroy)(AFlatMap* self);                              /**< Destroy the map and all of its entries */
+	APair*  (*const set)(AFlatMap* self, void* key, void* value);          /**< Set a value to a key */
+	void*   (*const get)(AFlatMap* self, const void* key);                 /**< Get a value from a key */
+	void    (*const remove)(AFlatMap* self, const void* key);              /**< Remove a key and its value */
+	APair** (*const range)(AFlatMap* self, const void* from,
+	                       const void* to, size_t* count);                 /**< Get the entries of a range of keys */
+	AFlatMap* (*const merge)(AFlatMap* self, const APair* pairs,
+	                         size_t count);                                /**< Set the values of many keys at once */
+	void*   (*const traverse)(AFlatMap* self, AFlatMapTraverseFunc func);  /**< Traverse all the entries in key order */
+
+	AValueComp comp;      /**< The comparison function */
+	AKeyComp keyComp;     /**< Descriptor of the comparison function (see AComp->describe()), made again when comp is replaced */
+	AValueFree freeKey;   /**< Key destructor function */
+	AValueFree freeValue; /**< Value destructor function */
+
+	AVector* pairs;       /*<  The key-value pairs, sorted by their keys */
+	size_t size;          /**< The number of entries in the map */
+};
+
+extern const AFlatMap AFlatMapProto;
+
+#endif /* AFLATMAP_H_ */
@@ -1,6 +1,12 @@
 #include "AHash.h"
+#include "AInternal.h"
 #include <string.h>
 
+/* The batch hash functions have an AVX2 implementation of MurmurHash2_x64 */
+#if defined(A_X86_SIMD) && defined(__x86_64__)
+#define AHASH_AVX2
+#endif
+
 size_t MurmurHash2_x86(const void* key, size_t len);
 size_t MurmurHash2_x64(const void* key, size_t len);
 
@@ -8,10 +14,27 @@ size_t pointerHash(const void* key);
 size_t intHash(const void* key);
 size_t stringHash(const void* key);
 
+static size_t AStringHashLength(const char* string, size_t* length);
+static size_t astringHash(const void* key);
+static void   AHashInit(AHashState* state);
+static void   AHashUpdate(AHashState* state, const void* data, size_t size);
+static size_t AHashFinal(const AHashState* state);
+static size_t AHashCombine(size_t seed, size_t hash);
+static void   AHashBatch(const void* keys, size_t size, size_t count, size_t* hashes);
+static void   AStringHashBatch(const char* const* strings, const size_t* sizes, size_t count, size_t* hashes);
+
 /* The hash function is MurmurHash2: https://code.google.com/p/smhasher/source/browse/trunk/MurmurHash2.cpp */
 #define hashFunc (sizeof(size_t) == 8 ? MurmurHash2_x64 : MurmurHash2_x86)
 
-static const __AHash _AHash = { hashFunc, pointerHash, intHash, stringHash };
+/* MurmurHash2 mixing constants for the native word size */
+#define MURMUR_M (sizeof(size_t) == 8 ? (size_t)0xc6a4a7935bd1e995ULL : (size_t)0x5bd1e995)
+#define MURMUR_R (sizeof(size_t) == 8 ? 47 : 24)
+
+static const __AHash _AHash =
+{
+	hashFunc, pointerHash, intHash, stringHash, AStringHashLength, astringHash,
+	AHashInit, AHashUpdate, AHashFinal, AHashCombine, AHashBatch, AStringHashBatch
+};
 const __AHash* AHash = &_AHash;
 
 size_t MurmurHash2_x86(const void* key, size_t len)
@@ -73,7 +96,9 @@ size_t MurmurHash2_x64(const void* key, size_t len)
 
 	while (data != end)
 	{
-		size_t k = *data++;
+		size_t k;
+
+		memcpy(&k, data++, sizeof k); /* the key may be unaligned */
 
 		k *= m;
 		k ^= k >> r;
@@ -116,5 +141,345 @@ size_t intHash(const void* key)
 
 size_t stringHash(const void* key)
 {
-	return hashFunc(key, strlen((const char*)key));
+	return AStringHashLength((const char *)key, NULL);
+}
+
+/*
+ * Mix the word 'k' into the hash value 'h'
+ */
+static size_t mixWord(size_t h, size_t k)
+{
+	k *= MURMUR_M;
+	k ^= k >> MURMUR_R;
+	k *= MURMUR_M;
+
+	h ^= k;
+	h *= MURMUR_M;
+
+	return h;
+}
+
+/*
+ * Do the final mixes of the hash value 'h' so all of its bits are well-incorporated
+ */
+static size_t finalMix(size_t h)
+{
+	if (sizeof(size_t) == 8)
+	{
+		h ^= h >> MURMUR_R;
+		h *= MURMUR_M;
+		h ^= h >> MURMUR_R;
+	}
+	else
+	{
+		h ^= h >> 13;
+		h *= MURMUR_M;
+		h ^= h >> 15;
+	}
+
+	return h;
+}
+
+/*
+ * Load 'len' (up to a word) bytes from 'data' into a word padded with zeros
+ */
+static size_t loadWord(const unsigned char* data, size_t len)
+{
+	size_t k = 0;
+
+#ifdef A_LITTLE_ENDIAN
+	/* A copy of a variable size is a call, so the last few bytes are loaded one by one */
+	if (len < sizeof(size_t))
+	{
+		switch (len)
+		{
+			case 7: k |= (size_t)data[6] << (sizeof(size_t) == 8 ? 48 : 0);
+			case 6: k |= (size_t)data[5] << (sizeof(size_t) == 8 ? 40 : 0);
+			case 5: k |= (size_t)data[4] << (sizeof(size_t) == 8 ? 32 : 0);
+			case 4: k |= (size_t)data[3] << 24;
+			case 3: k |= (size_t)data[2] << 16;
+			case 2: k |= (size_t)data[1] << 8;
+			case 1: k |= (size_t)data[0];
+		}
+
+		return k;
+	}
+#endif
+
+	memcpy(&k, data, len);
+	return k;
+}
+
+/*
+ * Finish the incremental hash of 'size' bytes, continuing from the hash value 'h'
+ * over the remaining 'len' bytes at 'data'
+ */
+static size_t streamFinish(size_t h, const unsigned char* data, size_t len, size_t size)
+{
+	for (; len >= sizeof(size_t); data += sizeof(size_t), len -= sizeof(size_t))
+	{
+		h = mixWord(h, loadWord(data, sizeof(size_t)));
+	}
+
+	h = mixWord(h, loadWord(data, len));
+	h = mixWord(h, size);
+
+	return finalMix(h);
+}
+
+static void AHashInit(AHashState* state)
+{
+	state->hash = 0;
+	state->size = 0;
+}
+
+static void AHashUpdate(AHashState* state, const void* data, size_t size)
+{
+	const unsigned char* bytes = (const unsigned char *)data;
+	size_t used = state->size % sizeof(size_t);
+	size_t k;
+
+	state->size += size;
+
+	/* Complete the word left incomplete by the previous update */
+	if (used > 0)
+	{
+		size_t missing = sizeof(size_t) - used;
+
+		if (missing > size)
+		{
+			missing = size;
+		}
+
+		memcpy(state->tail + used, bytes, missing);
+		bytes += missing;
+		size -= missing;
+
+		if (used + missing < sizeof(size_t))
+		{
+			return;
+		}
+
+		memcpy(&k, state->tail, sizeof k);
+		state->hash = mixWord(state->hash, k);
+	}
+
+	/* Mix a word at a time into the hash */
+	while (size >= sizeof(size_t))
+	{
+		memcpy(&k, bytes, sizeof k);
+		state->hash = mixWord(state->hash, k);
+
+		bytes += sizeof(size_t);
+		size -= sizeof(size_t);
+	}
+
+	/* Keep the last few bytes for the next update */
+	memcpy(state->tail, bytes, size);
+}
+
+/*
+ * MurmurHash2 words mixed in a MurmurHash2A-like order (this isn't the reference MurmurHash2A):
+ * the last incomplete word (padded with zeros) and the length are mixed in last, so the data can
+ * be fed incrementally.
+ */
+static size_t AHashFinal(const AHashState* state)
+{
+	return streamFinish(state->hash, state->tail, state->size % sizeof(size_t), state->size);
+}
+
+static size_t AHashCombine(size_t seed, size_t hash)
+{
+	return finalMix(mixWord(seed, hash));
+}
+
+/*
+ * The incremental hash of the string's characters. strlen() looks for the terminator
+ * faster than mixing the words could, and never reads past the memory of the string.
+ */
+static size_t AStringHashLength(const char* string, size_t* length)
+{
+	size_t size = strlen(string);
+
+	if (length != NULL)
+	{
+		*length = size;
+	}
+
+	return streamFinish(0, (const unsigned char *)string, size, size);
+}
+
+static size_t astringHash(const void* key)
+{
+	const AString* string = (const AString *)key;
+
+	return streamFinish(0, (const unsigned char *)string->data, string->length, string->length);
+}
+
+#ifdef AHASH_AVX2
+
+/*
+ * Multiply the 64 bit lanes of 'a' and 'b' (AVX2 only multiplies 32 bit halves)
+ */
+A_TARGET("avx2") static __m256i mul64x4(__m256i a, __m256i b)
+{
+	__m256i low = _mm256_mul_epu32(a, b);
+	__m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+	                                 _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+
+	return _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
+}
+
+/*
+ * mixWord() on 4 lanes
+ */
+A_TARGET("avx2") static __m256i mixWordx4(__m256i h, __m256i k, __m256i m)
+{
+	k = mul64x4(k, m);
+	k = _mm256_xor_si256(k, _mm256_srli_epi64(k, 47));
+	k = mul64x4(k, m);
+
+	return mul64x4(_mm256_xor_si256(h, k), m);
+}
+
+/*
+ * finalMix() on 4 lanes
+ */
+A_TARGET("avx2") static __m256i finalMixx4(__m256i h, __m256i m)
+{
+	h = _mm256_xor_si256(h, _mm256_srli_epi64(h, 47));
+	h = mul64x4(h, m);
+
+	return _mm256_xor_si256(h, _mm256_srli_epi64(h, 47));
+}
+
+/*
+ * Load a word of 'len' bytes at 'offset' from each of the 4 keys
+ */
+A_TARGET("avx2") static __m256i loadWordx4(const unsigned char* const keys[4], size_t offset, size_t len)
+{
+	return _mm256_set_epi64x((long long)loadWord(keys[3] + offset, len), (long long)loadWord(keys[2] + offset, len),
+	                         (long long)loadWord(keys[1] + offset, len), (long long)loadWord(keys[0] + offset, len));
+}
+
+/*
+ * MurmurHash2_x64 of 4 keys of 'size' bytes at a time ('size' is a multiple of 8)
+ */
+A_TARGET("avx2") static void hashBatchAVX2(const unsigned char* keys, size_t size, size_t count, size_t* hashes)
+{
+	const __m256i m = _mm256_set1_epi64x((long long)MURMUR_M);
+	size_t i, offset;
+
+	for (i = 0; i + 4 <= count; i += 4)
+	{
+		const unsigned char* lanes[4];
+		__m256i h = _mm256_set1_epi64x((long long)(size * MURMUR_M));
+
+		lanes[0] = keys + i * size;
+		lanes[1] = lanes[0] + size;
+		lanes[2] = lanes[1] + size;
+		lanes[3] = lanes[2] + size;
+
+		for (offset = 0; offset < size; offset += 8)
+		{
+			h = mixWordx4(h, loadWordx4(lanes, offset, 8), m);
+		}
+
+		_mm256_storeu_si256((__m256i *)(hashes + i), finalMixx4(h, m));
+	}
+
+	for (; i < count; i++)
+	{
+		hashes[i] = MurmurHash2_x64(keys + i * size, size);
+	}
+}
+
+/*
+ * The incremental hash of 4 strings at a time. The words all the 4 strings have
+ * are mixed together, and then each string is finished on its own.
+ */
+A_TARGET("avx2") static void stringHashBatchAVX2(const char* const* strings, const size_t* sizes,
+                                                 size_t count, size_t* hashes)
+{
+	const __m256i m = _mm256_set1_epi64x((long long)MURMUR_M);
+	size_t i, j, offset;
+
+	for (i = 0; i + 4 <= count; i += 4)
+	{
+		const unsigned char* lanes[4];
+		size_t lengths[4], common;
+		__m256i h;
+
+		for (j = 0; j < 4; j++)
+		{
+			lanes[j] = (const unsigned char *)strings[i + j];
+			lengths[j] = sizes != NULL ? sizes[i + j] : strlen(strings[i + j]);
+		}
+
+		common = lengths[0];
+		for (j = 1; j < 4; j++)
+		{
+			common = lengths[j] < common ? lengths[j] : common;
+		}
+
+		h = _mm256_setzero_si256();
+
+		for (offset = 0; offset + 8 <= common; offset += 8)
+		{
+			h = mixWordx4(h, loadWordx4(lanes, offset, 8), m);
+		}
+
+		_mm256_storeu_si256((__m256i *)(hashes + i), h);
+
+		for (j = 0; j < 4; j++)
+		{
+			hashes[i + j] = streamFinish(hashes[i + j], lanes[j] + offset, lengths[j] - offset, lengths[j]);
+		}
+	}
+
+	for (; i < count; i++)
+	{
+		hashes[i] = sizes != NULL ? streamFinish(0, (const unsigned char *)strings[i], sizes[i], sizes[i]) :
+		                            AStringHashLength(strings[i], NULL);
+	}
+}
+
+#endif /* AHASH_AVX2 */
+
+static void AHashBatch(const void* keys, size_t size, size_t count, size_t* hashes)
+{
+	size_t i;
+
+#ifdef AHASH_AVX2
+	/* The last bytes of other keys are loaded one lane at a time, slower than the scalar hash */
+	if (size >= 8 && size % 8 == 0 && A_CPU_SUPPORTS("avx2"))
+	{
+		hashBatchAVX2((const unsigned char *)keys, size, count, hashes);
+		return;
+	}
+#endif
+
+	for (i = 0; i < count; i++)
+	{
+		hashes[i] = hashFunc((const char *)keys + i * size, size);
+	}
+}
+
+static void AStringHashBatch(const char* const* strings, const size_t* sizes, size_t count, size_t* hashes)
+{
+	size_t i;
+
+#ifdef AHASH_AVX2
+	if (A_CPU_SUPPORTS("avx2"))
+	{
+		stringHashBatchAVX2(strings, sizes, count, hashes);
+		return;
+	}
+#endif
+
+	for (i = 0; i < count; i++)
+	{
+		hashes[i] = sizes != NULL ? streamFinish(0, (const unsigned char *)strings[i], sizes[i], sizes[i]) :
+		                            AStringHashLength(strings[i], NULL);
+	}
 }
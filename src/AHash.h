@@ -6,6 +6,7 @@
 #define AHASH_H_
 
 #include <stdlib.h>
+#include "AString.h"
 
 
 /**
@@ -19,6 +20,21 @@
  * @link hash AHash->hash()@endlink to implement your hash functions.
  */
 typedef size_t (*AHashFunc)(const void*);
+
+/**
+ * Incremental hash state
+ *
+ * The state of a hash computation which is fed its data in pieces. Initialize it
+ * with @link init AHash->init()@endlink, feed it with @link update AHash->update()@endlink
+ * and get the hash value with @link final AHash->final()@endlink. The fields are private.
+ */
+typedef struct AHashState
+{
+	size_t hash;                        /*<  Hash of all the complete words so far */
+	size_t size;                        /*<  Number of bytes hashed so far */
+	unsigned char tail[sizeof(size_t)]; /*<  Bytes of the last incomplete word */
+} AHashState;
+
 typedef struct __AHash __AHash;
 
 #ifdef DOXYGEN
@@ -29,6 +45,16 @@ struct
 	AHashFunc pointerHash; /**< Pointer hash function */
 	AHashFunc intHash;     /**< Integer hash function */
 	AHashFunc stringHash;  /**< String hash function  */
+	size_t (*const stringHashLength)(const char* string, size_t* length);    /**< Hash a string and get its length */
+	AHashFunc astringHash; /**< AString hash function */
+	void   (*const init)(AHashState* state);                                 /**< Start an incremental hash */
+	void   (*const update)(AHashState* state, const void* data, size_t size); /**< Feed an incremental hash */
+	size_t (*const final)(const AHashState* state);                          /**< Finish an incremental hash */
+	size_t (*const combine)(size_t seed, size_t hash);                       /**< Combine two hash values */
+	void   (*const hashBatch)(const void* keys, size_t size,
+	                          size_t count, size_t* hashes);                 /**< Hash an array of keys */
+	void   (*const stringHashBatch)(const char* const* strings, const size_t* sizes,
+	                                size_t count, size_t* hashes);           /**< Hash an array of strings */
 } *AHash;
 
 /**<
@@ -45,6 +71,15 @@ struct
  * @link pointerHash AHash->pointerHash@endlink,
  * @link intHash AHash->intHash@endlink,
  * @link stringHash AHash->stringHash@endlink,
+ *
+ * Keys which aren't stored in one contiguous buffer (such as composite keys or
+ * keys scattered across several buffers) can be hashed incrementally using
+ * @link init AHash->init()@endlink, @link update AHash->update()@endlink and
+ * @link final AHash->final()@endlink, or by combining the hash values of their
+ * fields using @link combine AHash->combine()@endlink.
+ *
+ * Many keys can be hashed at once using @link hashBatch AHash->hashBatch()@endlink
+ * and @link stringHashBatch AHash->stringHashBatch()@endlink.
  */
 
 /**
@@ -75,7 +110,121 @@ struct
 /**
  * @var AHashFunc stringHash
  *
- * Hash the string pointed to by the pointer.
+ * Hash the string pointed to by the pointer. The hash value is the same as the value
+ * of the incremental hash (see @link update AHash->update()@endlink) of all the characters
+ * of the string.
+ */
+
+/**
+ * @var size_t (*stringHashLength)(const char* string, size_t* length)
+ * @param string The string
+ * @param length Pointer to store the length of the string to (if it's not NULL)
+ * @return Hash value of the string
+ *
+ * Hash the string like @link stringHash AHash->stringHash@endlink, and get
+ * its length from the same pass over the string, without calling strlen().
+ */
+
+/**
+ * @var AHashFunc astringHash
+ *
+ * Hash the @link AString sized string@endlink pointed to by the pointer, without
+ * scanning it for a terminator. Gives the same value as @link stringHash AHash->stringHash@endlink
+ * gives for the same characters, so strings can be hashed once and looked up by either form.
+ */
+
+/**
+ * @var void (*init)(AHashState* state)
+ * @param state The hash state
+ *
+ * Start a new incremental hash computation.
+ */
+
+/**
+ * @var void (*update)(AHashState* state, const void* data, size_t size)
+ * @param state The hash state
+ * @param data Pointer to the next piece of data
+ * @param size Size of the data in bytes
+ *
+ * Feed the next piece of data to an incremental hash computation. The hash value
+ * depends only on the concatenation of all the pieces, so feeding "foo" and then "bar"
+ * yields the same hash value as feeding "foobar" at once.
+ *
+ * Example of hashing a composite key without copying it to a single buffer:
+ * @code
+ * struct Key { int id; const char* name; };
+ *
+ * size_t keyHash(const void* key)
+ * {
+ *     const struct Key* k = key;
+ *     AHashState state;
+ *
+ *     AHash->init(&state);
+ *     AHash->update(&state, &k->id, sizeof k->id);
+ *     AHash->update(&state, k->name, strlen(k->name));
+ *     return AHash->final(&state);
+ * }
+ * @endcode
+ */
+
+/**
+ * @var size_t (*final)(const AHashState* state)
+ * @param state The hash state
+ * @return Hash value of all the data fed to the state
+ *
+ * Finish an incremental hash computation. The state isn't modified, so more data can be
+ * fed to it afterwards. The incremental hash is AStruct's own variant of MurmurHash2: it mixes
+ * words like MurmurHash2 (MurmurHash64A on 64 bit platforms), and like MurmurHash2A it mixes the last
+ * incomplete word (padded with zeros) and the length of the data last. It doesn't match the reference
+ * values of any published MurmurHash variant, and its values differ from the values of
+ * @link hash AHash->hash()@endlink.
+ */
+
+/**
+ * @var size_t (*combine)(size_t seed, size_t hash)
+ * @param seed Hash value to combine into (use 0 to start)
+ * @param hash Hash value of the next field
+ * @return The combined hash value
+ *
+ * Combine the hash value of a field into the hash value of the fields before it.
+ * The result depends on the order of the fields.
+ */
+
+/**
+ * @var void (*hashBatch)(const void* keys, size_t size, size_t count, size_t* hashes)
+ * @param keys Array of keys
+ * @param size Size of each key in bytes
+ * @param count Number of keys in the array
+ * @param hashes Array of count hash values to fill
+ *
+ * Hash an array of fixed-size keys. hashes[i] is set to the same value
+ * @link hash AHash->hash()@endlink gives for the i-th key, but keys whose size is a multiple
+ * of 8 bytes (like 64 bit integers and pointers) are hashed several at the same time using SIMD
+ * instructions when the CPU supports them.
+ *
+ * Example of hashing many integers at once:
+ * @code
+ * int keys[1000];
+ * size_t hashes[1000];
+ *
+ * AHash->hashBatch(keys, sizeof *keys, 1000, hashes); // hashes[i] == AHash->intHash(&keys[i])
+ * @endcode
+ *
+ * Use sizeof(void*) as the size to get the values of @link pointerHash AHash->pointerHash@endlink
+ * for an array of pointers.
+ */
+
+/**
+ * @var void (*stringHashBatch)(const char* const* strings, const size_t* sizes, size_t count, size_t* hashes)
+ * @param strings Array of strings
+ * @param sizes Array of the lengths of the strings, or NULL to use strlen()
+ * @param count Number of strings in the array
+ * @param hashes Array of count hash values to fill
+ *
+ * Hash an array of strings. hashes[i] is set to the same value
+ * @link stringHash AHash->stringHash@endlink gives for the i-th string,
+ * but several strings are hashed at the same time using SIMD instructions
+ * when the CPU supports them.
  */
 
 #endif
@@ -86,6 +235,14 @@ struct __AHash
 	AHashFunc pointerHash;
 	AHashFunc intHash;
 	AHashFunc stringHash;
+	size_t (*const stringHashLength)(const char* string, size_t* length);
+	AHashFunc astringHash;
+	void   (*const init)(AHashState* state);
+	void   (*const update)(AHashState* state, const void* data, size_t size);
+	size_t (*const final)(const AHashState* state);
+	size_t (*const combine)(size_t seed, size_t hash);
+	void   (*const hashBatch)(const void* keys, size_t size, size_t count, size_t* hashes);
+	void   (*const stringHashBatch)(const char* const* strings, const size_t* sizes, size_t count, size_t* hashes);
 };
 
 extern const __AHash* AHash;
@@ -1,14 +1,16 @@
 #include <stdlib.h>
 #include "AStructBase.h"
 #include "AHashtable.h"
+#include "AInternal.h"
 
 /* Private hash table node functions */
 static AHashtableNode*  makeNode(void* key, void* value, AHashtableNode* next);
-static AHashtableNode*  lookupNode(AHashtableNode* start, void* key, AValueComp comp);
+static AHashtableNode** lookupLink(AHashtableNode** link, void* key, const AKeyComp* comp);
 static void             clearNode(AHashtableNode* node, AValueFree freeKey, AValueFree freeValue);
 static void             freeNode(AHashtableNode* node, AValueFree freeKey, AValueFree freeValue);
 
 static void    AHashtableMaybeExpand(AHashtable* self); /* private */
+static const AKeyComp* AHashtableKeyComp(AHashtable* self);
 
 static void*   AHashtableCreate(AHashtable* self, int numArgs, va_list args);
 static void    AHashtableClear(AHashtable* self);
@@ -42,22 +44,35 @@ static AHashtableNode* makeNode(void* key, void* value, AHashtableNode* next)
 }
 
 /*
- * Return the node with key 'key' using 'comp' function from a list starting from 'start'
- * Return NULL on error
+ * Return the link (pointer to the next pointer) to the node with key 'key' from a list starting
+ * at the link 'link', comparing keys of kind 'kind'. The link points to NULL if there's no such node
  */
-static AHashtableNode* lookupNode(AHashtableNode* start, void* key, AValueComp comp)
+static A_INLINE AHashtableNode** lookupKind(AHashtableNode** link, void* key, const AKeyComp* comp, AKeyKind kind)
 {
-	AHashtableNode* node;
-
-	for (node = start; node != NULL; node = node->next)
+	while (*link != NULL && !AKeysEqual(comp, kind, (*link)->key, key))
 	{
-		if (comp(node->key, key) == 0)
-		{
-			return node;
-		}
+		link = &(*link)->next;
 	}
 
-	return NULL;
+	return link;
+}
+
+/*
+ * Return the link to the node with key 'key' using the descriptor 'comp' (see lookupKind()).
+ * The built-in kinds of keys get their own loop, so keys are compared inline.
+ */
+static AHashtableNode** lookupLink(AHashtableNode** link, void* key, const AKeyComp* comp)
+{
+	switch (comp->kind)
+	{
+		case AKeyInt32:   return lookupKind(link, key, comp, AKeyInt32);
+		case AKeyInt64:   return lookupKind(link, key, comp, AKeyInt64);
+		case AKeyPointer: return lookupKind(link, key, comp, AKeyPointer);
+		case AKeyString:  return lookupKind(link, key, comp, AKeyString);
+		case AKeyBytes:   return lookupKind(link, key, comp, AKeyBytes);
+		case AKeyAString: return lookupKind(link, key, comp, AKeyAString);
+		default:          return lookupKind(link, key, comp, AKeyCustom);
+	}
 }
 
 /*
@@ -85,6 +100,20 @@ static void freeNode(AHashtableNode* node, AValueFree freeKey, AValueFree freeVa
 	free(node);
 }
 
+/*
+ * The descriptor of the comparison function of the hash table 'self', described again if
+ * AHashtable::comp was replaced after the descriptor was made
+ */
+static const AKeyComp* AHashtableKeyComp(AHashtable* self)
+{
+	if (self->keyComp.comp != self->comp)
+	{
+		self->keyComp = AComp->describe(self->comp);
+	}
+
+	return &self->keyComp;
+}
+
 /*
  * Expand the hash table 'self' if the buckets contain too much nodes on average
  */
@@ -164,6 +193,7 @@ static void* AHashtableCreate(AHashtable* self, int numArgs, va_list args)
 
 	self->hash = va_arg(args, AHashFunc);
 	self->comp = va_arg(args, AValueComp);
+	self->keyComp = AComp->describe(self->comp);
 	self->freeKey = NULL;
 	self->freeValue = NULL;
 
@@ -254,7 +284,7 @@ static APair* AHashtableSet(AHashtable* self, void* key, void* value)
 
 	AHashtableMaybeExpand(self);
 	bucket = self->hash(key) & self->capacity;
-	node = lookupNode(self->table[bucket], key, self->comp);
+	node = *lookupLink(&self->table[bucket], key, AHashtableKeyComp(self));
 
 	/* New key */
 	if (node == NULL)
@@ -292,7 +322,7 @@ static void* AHashtableGet(AHashtable* self, void* key)
 	AHashtableNode* node;
 	size_t bucket = self->hash(key) & self->capacity;
 
-	if ((node = lookupNode(self->table[bucket], key, self->comp)) == NULL)
+	if ((node = *lookupLink(&self->table[bucket], key, AHashtableKeyComp(self))) == NULL)
 	{
 		return NULL;
 	}
@@ -311,32 +341,16 @@ static void* AHashtableGet(AHashtable* self, void* key)
  */
 static void AHashtableRemove(AHashtable* self, void* key)
 {
-	AValueComp comp = self->comp;
 	size_t bucket = self->hash(key) & self->capacity;
-	AHashtableNode* prev = NULL;
-	AHashtableNode* current = self->table[bucket];
-
-	/* Look up the key */
-	while (current != NULL)
-	{
-		if (comp(current->key, key) == 0)
-		{
-			break;
-		}
-
-		prev = current;
-		current = current->next;
-	}
+	AHashtableNode** link = lookupLink(&self->table[bucket], key, AHashtableKeyComp(self));
+	AHashtableNode* current = *link;
 
-	if (prev == NULL) /* first node in the bucket */
+	if (current == NULL) /* no such key */
 	{
-		self->table[bucket] = current->next;
-	}
-	else
-	{
-		prev->next = current->next;
+		return;
 	}
 
+	*link = current->next;
 	freeNode(current, self->freeKey, self->freeValue);
 	self->size--;
 	self->lists -= self->table[bucket] == NULL;
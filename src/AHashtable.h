@@ -69,6 +69,16 @@ typedef struct AHashtable AHashtable;
  * // Create a new hash table with default capacity using doubles as keys. Nothing will be freed.
  * AHashtable* table = AStruct->ANew(AHashtable, doubleHash, doubleComp);
  * @endcode
+ *
+ * Keys compared by the comparison functions of ::AComp are compared inline, without calling
+ * the function for each key in a bucket. Keys of a fixed size compared like memcmp() can be
+ * compared inline too by setting @link AHashtable::keyComp keyComp@endlink before inserting any key:
+ * @code
+ * table->keyComp.kind = AKeyBytes;
+ * table->keyComp.size = sizeof(struct Key);
+ * @endcode
+ * The descriptor is made again from @link AHashtable::comp comp@endlink if the comparison
+ * function is replaced later, so set it again after replacing the function.
  */
 struct AHashtable
 {
@@ -82,6 +92,7 @@ struct AHashtable
 
 	AHashFunc hash;         /**< The hash function */
 	AValueComp comp;        /**< The comparison function */
+	AKeyComp keyComp;       /**< Descriptor of the comparison function (see AComp->describe()), made again when comp is replaced */
 	AValueFree freeKey;     /**< Key destructor function */
 	AValueFree freeValue;   /**< Value destructor function */
 
@@ -0,0 +1,165 @@
+/*
+ * Internal helpers shared by the AStruct sources. This header is not
+ * part of the public interface and isn't installed.
+ */
+
+#ifndef AINTERNAL_H_
+#define AINTERNAL_H_
+
+#include <stddef.h>
+#include <string.h>
+#include "AComp.h"
+
+#ifdef _MSC_VER
+#define A_INLINE __inline
+#else
+#define A_INLINE inline
+#endif
+
+/*
+ * x86 SIMD kernels are compiled for their instruction set with a per-function
+ * target attribute, and are chosen at runtime by checking the CPU. So the library
+ * itself is built for the baseline target and runs everywhere.
+ */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define A_X86_SIMD
+#define A_TARGET(isa) __attribute__((target(isa)))
+#define A_CPU_SUPPORTS(isa) __builtin_cpu_supports(isa)
+#endif
+
+/*
+ * Memory mapping (A_MREMAP where a mapping can be resized without copying it). Sources
+ * using A_MREMAP define _GNU_SOURCE before including any header.
+ */
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <unistd.h>
+#define A_MMAP
+#if defined(__linux__) && defined(MREMAP_MAYMOVE)
+#define A_MREMAP
+#endif
+#endif
+
+/*
+ * Size of a transparent huge page (where the system has them)
+ */
+#define A_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__) || \
+    (defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define A_LITTLE_ENDIAN
+#endif
+
+/*
+ * Number of trailing zero bits in the non-zero word x, and the index of its highest set bit
+ */
+#ifdef _MSC_VER
+#include <intrin.h>
+static A_INLINE unsigned ACountTrailingZeros(size_t x)
+{
+	unsigned long index;
+#ifdef _WIN64
+	_BitScanForward64(&index, x);
+#else
+	_BitScanForward(&index, x);
+#endif
+	return index;
+}
+
+static A_INLINE unsigned AHighestBit(size_t x)
+{
+	unsigned long index;
+#ifdef _WIN64
+	_BitScanReverse64(&index, x);
+#else
+	_BitScanReverse(&index, x);
+#endif
+	return index;
+}
+#else
+#define ACountTrailingZeros(x) ((unsigned)__builtin_ctzll(x))
+#define AHighestBit(x) (63 - (unsigned)__builtin_clzll(x))
+#endif
+
+/*
+ * Atomic reference counts of type long. AAtomicIncrement() and AAtomicDecrement() return the new count,
+ * and a count which drops to 0 makes all the writes of the other threads which held a reference visible.
+ */
+#ifdef _MSC_VER
+#define AAtomicIncrement(p) _InterlockedIncrement(p)
+#define AAtomicDecrement(p) _InterlockedDecrement(p)
+#define AAtomicLoad(p) (*(volatile long *)(p))
+#else
+#define AAtomicIncrement(p) __atomic_add_fetch(p, 1, __ATOMIC_RELAXED)
+#define AAtomicDecrement(p) __atomic_sub_fetch(p, 1, __ATOMIC_ACQ_REL)
+#define AAtomicLoad(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#endif
+
+/*
+ * Number of set bits in the 64-bit word x. Functions compiled with A_TARGET("popcnt") get the POPCNT instruction.
+ */
+#ifdef _MSC_VER
+static A_INLINE unsigned APopCount(unsigned long long x)
+{
+	x -= (x >> 1) & 0x5555555555555555ULL;
+	x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+	x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+	return (unsigned)((x * 0x0101010101010101ULL) >> 56);
+}
+#else
+#define APopCount(x) ((unsigned)__builtin_popcountll(x))
+#endif
+
+/*
+ * Where the index'th of 'parts' (almost) equal parts of 'size' items starts, for splitting work
+ * across the threads of AParallel. The part 'parts' starts at 'size', so the parts cover every item.
+ */
+static A_INLINE size_t ASplit(size_t size, size_t index, size_t parts)
+{
+	return size / parts * index + size % parts * index / parts;
+}
+
+/*
+ * Compare sized strings (like AComp->astringComp), or only check whether they're equal
+ */
+int AStringCompare(const AString* a, const AString* b);
+int AStringEqual(const AString* a, const AString* b);
+
+/*
+ * Whether the keys 'a' and 'b' are equal by the comparison descriptor 'comp' of kind 'kind'.
+ * Switch on comp->kind outside of a loop and pass the constant kind to get an inlined loop.
+ */
+static A_INLINE int AKeysEqual(const AKeyComp* comp, AKeyKind kind, const void* a, const void* b)
+{
+	switch (kind)
+	{
+		case AKeyInt32:   return *(const int *)a == *(const int *)b;
+		case AKeyInt64:   return *(const long long *)a == *(const long long *)b;
+		case AKeyPointer: return a == b;
+		case AKeyString:  return strcmp((const char *)a, (const char *)b) == 0;
+		case AKeyBytes:   return memcmp(a, b, comp->size) == 0;
+		case AKeyAString: return AStringEqual((const AString *)a, (const AString *)b);
+		default:          return comp->comp(a, b) == 0;
+	}
+}
+
+/*
+ * Compare the keys 'a' and 'b' by the comparison descriptor 'comp' of kind 'kind' (see AKeysEqual())
+ */
+static A_INLINE int AKeysCompare(const AKeyComp* comp, AKeyKind kind, const void* a, const void* b)
+{
+	switch (kind)
+	{
+		case AKeyInt32:   return (*(const int *)a > *(const int *)b) - (*(const int *)a < *(const int *)b);
+		case AKeyInt64:   return (*(const long long *)a > *(const long long *)b) -
+		                         (*(const long long *)a < *(const long long *)b);
+		case AKeyPointer: return ((const char *)a > (const char *)b) - ((const char *)a < (const char *)b);
+		case AKeyString:  return strcmp((const char *)a, (const char *)b);
+		case AKeyBytes:   return memcmp(a, b, comp->size);
+		case AKeyAString: return AStringCompare((const AString *)a, (const AString *)b);
+		default:          return comp->comp(a, b);
+	}
+}
+
+#endif /* AINTERNAL_H_ */
@@ -4,6 +4,26 @@
 #include "AStructBase.h"
 #include "AList.h"
 
+/* A slab of nodes, followed by the nodes themselves */
+struct AListSlab
+{
+	AListSlab* next;
+	size_t capacity;  /* Number of nodes in the slab */
+	size_t used;      /* Number of nodes taken from the slab (the rest were never used) */
+};
+
+static AListNode*   AListPoolSlab(AListPool* pool, size_t capacity, size_t used); /* Private functions */
+static void         AListPoolFreeSlabs(AListPool* pool);
+static void         AListPoolMerge(AListPool* pool, AListPool* other);
+static AListNode*   AListNewNodes(AList* self, size_t count);
+static AListNode*   AListNewNode(AList* self);
+static void         AListFreeNode(AList* self, AListNode* node);
+static void         AListLink(AList* self, AListNode* nodes, size_t count);
+static int          AListRehome(AList* self, AList* other);
+
+static void*        AListPoolCreate(AListPool* self, int numArgs, va_list args);
+static void         AListPoolDestroy(AListPool* self);
+
 static void*        AListCreate(AList* self, int numArgs, va_list args);
 static void         AListClear(AList* self, AValueFree freeValue);
 static void         AListDestroy(AList* self, AValueFree freeValue);
@@ -23,7 +43,7 @@ static AList*       AListCopy(AList* self, AValueFunc copyValue);
 static AList*       AListSplitReal(AList* self, AListNode* node);
 static AList*       AListSplit(AList* self, AListNode* node);
 static AList*       AListSplitAt(AList* self, size_t pos);
-static void         AListJoin(AList* first, AList* second);
+static AList*       AListJoin(AList* first, AList* second);
 
 const AList AListProto =
 {
@@ -32,6 +52,233 @@ const AList AListProto =
 	AListSplit,	AListSplitAt, AListJoin
 };
 
+const AListPool AListPoolProto =
+{
+	AListPoolCreate, AListPoolDestroy
+};
+
+/* Number of nodes in the first slab of a pool */
+#define MIN_SLAB_CAPACITY 8
+
+/* The nodes of a slab */
+#define slabNodes(slab) ((AListNode *)((slab) + 1))
+
+/*
+ * Create a new pool of nodes
+ */
+static void* AListPoolCreate(AListPool* self, int numArgs, va_list args)
+{
+	self->refs = 1;
+	self->freeNodes = NULL;
+	self->slabs = NULL;
+	self->slabCapacity = MIN_SLAB_CAPACITY;
+
+	return self;
+}
+
+/**
+ * @fn void (*AListPool::destroy)(AListPool* self)
+ * @param self The pool
+ *
+ * Give up the pool. Its storage is freed once all the lists using it are destroyed too.
+ * Any access to a destroyed pool is forbidden.
+ */
+static void AListPoolDestroy(AListPool* self)
+{
+	if (self != NULL && --self->refs == 0)
+	{
+		AListPoolFreeSlabs(self);
+		free(self);
+	}
+}
+
+/*
+ * Allocate a slab of 'capacity' nodes and return its nodes, of which 'used' nodes are taken.
+ * A full slab is placed after the slab nodes are taken from, so the rest of that one is still used.
+ */
+static AListNode* AListPoolSlab(AListPool* pool, size_t capacity, size_t used)
+{
+	AListSlab* slab;
+
+	if (capacity > ((size_t)-1 - sizeof *slab) / sizeof(AListNode) ||
+	    (slab = malloc(sizeof *slab + capacity * sizeof(AListNode))) == NULL)
+	{
+		return NULL;
+	}
+
+	slab->capacity = capacity;
+	slab->used = used;
+
+	if (used == capacity && pool->slabs != NULL)
+	{
+		slab->next = pool->slabs->next;
+		pool->slabs->next = slab;
+	}
+	else
+	{
+		slab->next = pool->slabs;
+		pool->slabs = slab;
+	}
+
+	return slabNodes(slab);
+}
+
+/*
+ * Free all the slabs of the pool, which mustn't have nodes used by any list,
+ * and start again from small slabs
+ */
+static void AListPoolFreeSlabs(AListPool* pool)
+{
+	AListSlab* slab = pool->slabs;
+
+	while (slab != NULL)
+	{
+		AListSlab* temp = slab;
+		slab = slab->next;
+		free(temp);
+	}
+
+	pool->slabs = NULL;
+	pool->freeNodes = NULL;
+	pool->slabCapacity = MIN_SLAB_CAPACITY;
+}
+
+/*
+ * Move the slabs and the free nodes of 'other' (which is used by one list only) to 'pool', and free 'other'
+ */
+static void AListPoolMerge(AListPool* pool, AListPool* other)
+{
+	AListSlab* slab = other->slabs;
+	AListNode* node = other->freeNodes;
+
+	if (slab != NULL)
+	{
+		while (slab->next != NULL)
+		{
+			slab = slab->next;
+		}
+
+		if (pool->slabs != NULL) /* Keep taking nodes from the current slab */
+		{
+			slab->next = pool->slabs->next;
+			pool->slabs->next = other->slabs;
+		}
+		else
+		{
+			pool->slabs = other->slabs;
+		}
+	}
+
+	if (node != NULL)
+	{
+		while (node->next != NULL)
+		{
+			node = node->next;
+		}
+
+		node->next = pool->freeNodes;
+		pool->freeNodes = other->freeNodes;
+	}
+
+	free(other);
+}
+
+/*
+ * Allocate 'count' nodes in one block, from the pool of the list
+ */
+static AListNode* AListNewNodes(AList* self, size_t count)
+{
+	if (self->pool == NULL && (self->pool = AStruct->ANew(AListPool)) == NULL)
+	{
+		return NULL;
+	}
+
+	return AListPoolSlab(self->pool, count, count);
+}
+
+/*
+ * Allocate a node from the pool of the list: a node which was removed, or the next one of the current slab
+ */
+static AListNode* AListNewNode(AList* self)
+{
+	const size_t MAX_SLAB_CAPACITY = 1024;
+	AListPool* pool = self->pool;
+	AListSlab* slab;
+	AListNode* node;
+
+	if (pool == NULL && (pool = self->pool = AStruct->ANew(AListPool)) == NULL)
+	{
+		return NULL;
+	}
+
+	if ((node = pool->freeNodes) != NULL)
+	{
+		pool->freeNodes = node->next;
+	}
+	else if ((slab = pool->slabs) != NULL && slab->used < slab->capacity)
+	{
+		node = slabNodes(slab) + slab->used++;
+	}
+	else if ((node = AListPoolSlab(pool, pool->slabCapacity, 1)) != NULL && pool->slabCapacity < MAX_SLAB_CAPACITY)
+	{
+		pool->slabCapacity *= 2;
+	}
+
+	return node;
+}
+
+/*
+ * Give the node back to the pool of the list
+ */
+static void AListFreeNode(AList* self, AListNode* node)
+{
+	node->next = self->pool->freeNodes;
+	self->pool->freeNodes = node;
+}
+
+/*
+ * Link a block of 'count' nodes, which already have their values, in order and make them the nodes of the list
+ */
+static void AListLink(AList* self, AListNode* nodes, size_t count)
+{
+	size_t i;
+
+	for (i = 0; i < count; i++)
+	{
+		nodes[i].prev = i > 0 ? &nodes[i - 1] : NULL;
+		nodes[i].next = i + 1 < count ? &nodes[i + 1] : NULL;
+	}
+
+	self->head = nodes;
+	self->tail = &nodes[count - 1];
+	self->size = count;
+}
+
+/*
+ * Move the values of 'other' to nodes from the pool of the list 'self', in one block
+ */
+static int AListRehome(AList* self, AList* other)
+{
+	AListNode* nodes = AListNewNodes(self, other->size);
+	AListNode* node;
+	size_t i, size = other->size;
+
+	if (nodes == NULL)
+	{
+		return 0;
+	}
+
+	for (node = other->head, i = 0; i < size; node = node->next, i++)
+	{
+		nodes[i].value = node->value;
+	}
+
+	AListClear(other, NULL);
+	AListLink(other, nodes, size);
+
+	return 1;
+}
+
 /*
  * Create a new list
  */
@@ -39,6 +286,13 @@ static void* AListCreate(AList* self, int numArgs, va_list args)
 {
 	self->head = self->tail = NULL;
 	self->size = 0;
+	self->pool = NULL;
+
+	/* If the user supplied a pool argument, share it */
+	if (numArgs > 0 && (self->pool = va_arg(args, AListPool*)) != NULL)
+	{
+		self->pool->refs++;
+	}
 
 	return self;
 }
@@ -50,10 +304,12 @@ static void* AListCreate(AList* self, int numArgs, va_list args)
  *
  * Clear the list by removing all the nodes and their values
  * using freeValue to free the values (if it's not NULL).
+ * If the pool of the list isn't shared, its slabs are freed.
  */
 static void AListClear(AList* self, AValueFree freeValue)
 {
 	AListNode* node = self->head;
+	int ownPool = self->pool != NULL && self->pool->refs == 1;
 
 	while (node != NULL)
 	{
@@ -65,7 +321,15 @@ static void AListClear(AList* self, AValueFree freeValue)
 			freeValue(temp->value);
 		}
 
-		free(temp);
+		if (!ownPool)
+		{
+			AListFreeNode(self, temp);
+		}
+	}
+
+	if (ownPool)
+	{
+		AListPoolFreeSlabs(self->pool);
 	}
 
 	self->head = self->tail = NULL;
@@ -85,6 +349,7 @@ static void AListDestroy(AList* self, AValueFree freeValue)
 	if (self != NULL)
 	{
 		AListClear(self, freeValue);
+		AListPoolDestroy(self->pool);
 		free(self);
 	}
 }
@@ -97,7 +362,7 @@ static void AListDestroy(AList* self, AValueFree freeValue)
  */
 static AListNode* AListAppend(AList* self, void* value)
 {
-	AListNode* node = malloc(sizeof *node);
+	AListNode* node = AListNewNode(self);
 
 	if (node != NULL)
 	{
@@ -156,7 +421,7 @@ static void* AListPopLast(AList* self)
  */
 static AListNode* AListPrepend(AList* self, void* value)
 {
-	AListNode* node = malloc(sizeof *node);
+	AListNode* node = AListNewNode(self);
 
 	if (node != NULL)
 	{
@@ -225,9 +490,7 @@ static AListNode* AListInsert(AList* self, AListNode* prev, void* value)
 		return AListAppend(self, value);
 	}
 
-	node = malloc(sizeof *node);
-
-	if (node != NULL && prev != NULL)
+	if (prev != NULL && (node = AListNewNode(self)) != NULL)
 	{
 		node->value = value;
 		node->next = prev->next;
@@ -408,7 +671,7 @@ static void* AListRemove(AList* self, AListNode* node)
 	}
 
 	value = node->value;
-	free(node);
+	AListFreeNode(self, node);
 	self->size--;
 
 	return value;
@@ -453,22 +716,30 @@ static void* AListRemoveAt(AList* self, size_t pos)
  * @return A new copy of the list or NULL on error
  *
  * Create a new copy of the list and all of its values (if copyValue isn't NULL)
- * and return the new list.
+ * and return the new list. The nodes of the copy are allocated in one block,
+ * in the order of the list, from a pool of its own.
  */
 static AList* AListCopy(AList* self, AValueFunc copyValue)
 {
 	AListNode* node = self->head;
 	AList* newList = AStruct->ANew(AList);
+	AListNode* nodes;
+	size_t i;
 
-	if (newList != NULL)
+	if (newList != NULL && self->size > 0)
 	{
-		while (node != NULL)
+		if ((nodes = AListNewNodes(newList, self->size)) == NULL)
 		{
-			newList->append(newList, copyValue != NULL ? copyValue(node->value) : node->value);
-			node = node->next;
+			AListDestroy(newList, NULL);
+			return NULL;
+		}
+
+		for (i = 0; i < self->size; node = node->next, i++)
+		{
+			nodes[i].value = copyValue != NULL ? copyValue(node->value) : node->value;
 		}
 
-		newList->size = self->size;
+		AListLink(newList, nodes, self->size);
 	}
 
 	return newList;
@@ -476,11 +747,11 @@ static AList* AListCopy(AList* self, AValueFunc copyValue)
 
 /*
  * Split the list 'self' by node 'node' and return the second list
- * (which will include the node). Don't change the sizes of the lists.
+ * (which will include the node and share the pool). Don't change the sizes of the lists.
  */
 static AList* AListSplitReal(AList* self, AListNode* node)
 {
-	AList* newList = AStruct->ANew(AList);
+	AList* newList = AStruct->ANew(AList, self->pool);
 
 	if (newList != NULL)
 	{
@@ -580,19 +851,58 @@ static AList* AListSplitAt(AList* self, size_t pos)
 }
 
 /**
- * @fn void (*AList::join)(AList* first, AList* second)
+ * @fn AList* (*AList::join)(AList* first, AList* second)
  * @param first The first list
  * @param second The second list
+ * @return The first list or NULL on error
  *
  * Join the first list with the second list. The second list
- * will be destroyed afterwards.
+ * is destroyed afterwards, unless the join fails.
+ *
+ * Lists sharing a pool are joined in constant time, and so are lists whose
+ * second list has a pool of its own (which the first list takes over).
+ * Otherwise the nodes of the second list are moved to the pool of the first
+ * one. If they can't be allocated the join fails, and both lists are left
+ * unchanged: the second list is still valid, and must still be destroyed.
  */
-static void AListJoin(AList* first, AList* second)
+static AList* AListJoin(AList* first, AList* second)
 {
-	first->tail->next = second->head;
-	second->head->prev = first->tail;
-	first->tail = second->tail;
+	if (second->head != NULL && first->pool != NULL && second->pool != first->pool)
+	{
+		if (second->pool->refs == 1)
+		{
+			AListPoolMerge(first->pool, second->pool);
+			second->pool = NULL;
+		}
+		else if (!AListRehome(first, second))
+		{
+			return NULL;
+		}
+	}
+	else if (first->pool == NULL) /* The first list never had nodes */
+	{
+		first->pool = second->pool;
+		second->pool = NULL;
+	}
 
-	first->size += second->size;
+	if (second->head != NULL)
+	{
+		if (first->tail == NULL)
+		{
+			first->head = second->head;
+		}
+		else
+		{
+			first->tail->next = second->head;
+			second->head->prev = first->tail;
+		}
+
+		first->tail = second->tail;
+		first->size += second->size;
+	}
+
+	AListPoolDestroy(second->pool);
 	free(second);
+
+	return first;
 }
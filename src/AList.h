@@ -24,6 +24,44 @@ struct AListNode
 	AListNode* next; /**< Next node */
 };
 
+typedef struct AListPool AListPool;
+typedef struct AListSlab AListSlab;
+
+/**
+ * Pool of @link AListNode list nodes@endlink
+ *
+ * The pool allocates nodes in slabs of many nodes each, and keeps the nodes removed from its lists to reuse
+ * them, so appending to a list rarely calls malloc(). A list uses a pool of its own unless it's created with
+ * a pool to share with other lists. Lists split from a list share its pool.
+ *
+ * The pool is freed when it's been destroyed and all the lists using it have been destroyed too. A pool
+ * isn't thread safe: the lists sharing it must be changed by one thread at a time.
+ *
+ * The arguments passed to @link ANew AStruct->ANew()@endlink to create a new pool are:
+ * @code AStruct->ANew(AListPool) @endcode
+ * No additional arguments should be passed.
+ *
+ * Example of sharing a pool between lists:
+ * @code
+ * AListPool* pool = AStruct->ANew(AListPool);
+ * AList* ready = AStruct->ANew(AList, pool);
+ * AList* waiting = AStruct->ANew(AList, pool);
+ * pool->destroy(pool); // The lists keep the pool until they're destroyed
+ * @endcode
+ */
+struct AListPool
+{
+	void* (*const create)(AListPool* self, int numArgs, va_list args);  /*<  Default creator function called by AStruct->ANew() */
+	void  (*const destroy)(AListPool* self);                            /**< Destroy the pool once its lists are destroyed */
+
+	size_t refs;           /*<  Number of lists and owners using the pool */
+	AListNode* freeNodes;  /*<  Nodes removed from the lists, linked by their next pointers */
+	AListSlab* slabs;      /*<  The slabs of nodes, the one nodes are taken from first */
+	size_t slabCapacity;   /*<  Number of nodes in the next slab */
+};
+
+extern const AListPool AListPoolProto;
+
 typedef struct AList AList;
 
 /**
@@ -34,9 +72,12 @@ typedef struct AList AList;
  * appropriate for storing a collection of values. Random access to values is linear. If you need
  * fast random access use AVector.
  *
+ * The nodes are allocated from an AListPool, and AList::copy() allocates all the nodes of the copy in one
+ * block in the order of the list, so walking a copied list reads memory sequentially.
+ *
  * The arguments passed to @link ANew AStruct->ANew()@endlink to create a new list are:
- * @code AStruct->ANew(AList) @endcode
- * No additional arguments should be passed.
+ * @code AStruct->ANew(AList, AListPool* pool) @endcode
+ * @param [opt]pool Optional argument to specify a pool to share with other lists (or NULL for a pool of its own)
  *
  * Example of creating a new list:
  * @code AList* list = AStruct->ANew(AList); @endcode
@@ -61,11 +102,12 @@ struct AList
 	AList*      (*const copy)(AList* self, AValueFunc copyValue);            /**< Copy the entire list */
 	AList*      (*const split)(AList* self, AListNode* node);                /**< Split the list by a node */
 	AList*      (*const splitAt)(AList* self, size_t pos);                   /**< Split the list by a position */
-	void        (*const join)(AList* first, AList* second);                  /**< Join two lists */
+	AList*      (*const join)(AList* first, AList* second);                  /**< Join two lists */
 
 	size_t size;      /**< Number of nodes in the list */
 	AListNode* head;  /**< First node in the list */
 	AListNode* tail;  /**< Last node in the list */
+	AListPool* pool;  /*<  The pool of the nodes (NULL until the first node is allocated) */
 };
 
 extern const AList AListProto;
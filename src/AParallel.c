@@ -0,0 +1,242 @@
+#include "AParallel.h"
+
+/*
+ * Threads are POSIX threads, and pieces of work are handed out using an atomic counter
+ */
+#if !defined(_WIN32) && (defined(__GNUC__) || defined(__clang__))
+#include <pthread.h>
+#include <unistd.h>
+#define APARALLEL_THREADS
+#endif
+
+static void   setThreads(size_t threads);
+static size_t threads(void);
+static void   run(AParallelTask task, void* arg, size_t count);
+static void   shutdown(void);
+
+static const __AParallel _AParallel = { setThreads, threads, run, shutdown };
+const __AParallel* AParallel = &_AParallel;
+
+static size_t numThreads = 0; /* 0 until it's set or first needed (guarded by 'lock' where there are threads) */
+
+/* Work split across the threads by run() */
+typedef struct AParallelJob
+{
+	AParallelTask task;
+	void* arg;
+	size_t count;
+	size_t next; /* Index of the next piece of work to hand out */
+} AParallelJob;
+
+#ifdef APARALLEL_THREADS
+/*
+ * The pool of worker threads
+ *
+ * The workers are started by the first job which needs them and wait for the following jobs, so a job
+ * doesn't pay for starting threads. A job is run by one caller at a time: the caller holding 'busy'.
+ * Other callers, including tasks which run jobs of their own, run their jobs on their own thread.
+ */
+static pthread_mutex_t busy = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;  /* Guards all the pool state below */
+static pthread_cond_t started = PTHREAD_COND_INITIALIZER; /* Signaled when a job starts or the pool stops */
+static pthread_cond_t done = PTHREAD_COND_INITIALIZER;    /* Signaled when the last worker finishes a job */
+static pthread_t* workers = NULL;
+static size_t numWorkers = 0;
+static AParallelJob* current = NULL;                      /* The job the workers run */
+static unsigned long generation = 0;                      /* Number of jobs started so far */
+static unsigned long poolGeneration = 0;                  /* Number of jobs started before the workers */
+static size_t active = 0;                                 /* Number of workers still running the job */
+static int stopping = 0;
+
+#define lockPool()   pthread_mutex_lock(&lock)
+#define unlockPool() pthread_mutex_unlock(&lock)
+#else
+#define lockPool()
+#define unlockPool()
+#endif
+
+static void setThreads(size_t threads)
+{
+	lockPool();
+	numThreads = threads;
+	unlockPool();
+}
+
+static size_t threads(void)
+{
+	size_t count;
+
+	lockPool();
+
+	if (numThreads == 0)
+	{
+#if defined(APARALLEL_THREADS) && defined(_SC_NPROCESSORS_ONLN)
+		long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		numThreads = cpus > 0 ? (size_t)cpus : 1;
+#else
+		numThreads = 1;
+#endif
+	}
+
+	count = numThreads;
+	unlockPool();
+
+	return count;
+}
+
+#ifdef APARALLEL_THREADS
+/*
+ * Run pieces of the job until all of them were handed out
+ */
+static void work(AParallelJob* job)
+{
+	size_t index;
+
+	while ((index = __atomic_fetch_add(&job->next, 1, __ATOMIC_RELAXED)) < job->count)
+	{
+		job->task(job->arg, index);
+	}
+}
+
+/*
+ * Worker thread: wait for a job, work on it, and wait for the next one
+ */
+static void* worker(void* arg)
+{
+	unsigned long seen;
+	AParallelJob* job;
+
+	pthread_mutex_lock(&lock);
+	seen = poolGeneration; /* The first job may have started before this thread */
+
+	for (;;)
+	{
+		while (generation == seen && !stopping)
+		{
+			pthread_cond_wait(&started, &lock);
+		}
+
+		if (stopping)
+		{
+			break;
+		}
+
+		seen = generation;
+		job = current;
+		pthread_mutex_unlock(&lock);
+
+		work(job);
+
+		pthread_mutex_lock(&lock);
+
+		if (--active == 0)
+		{
+			pthread_cond_signal(&done);
+		}
+	}
+
+	pthread_mutex_unlock(&lock);
+	return arg;
+}
+
+/*
+ * Stop all the workers and wait for them to exit
+ */
+static void stopPool(void)
+{
+	size_t i;
+
+	pthread_mutex_lock(&lock);
+	stopping = 1;
+	pthread_cond_broadcast(&started);
+	pthread_mutex_unlock(&lock);
+
+	for (i = 0; i < numWorkers; i++)
+	{
+		pthread_join(workers[i], NULL);
+	}
+
+	free(workers);
+	workers = NULL;
+	numWorkers = 0;
+	stopping = 0;
+}
+
+/*
+ * Make the pool have 'count' workers (or as many as could be started)
+ */
+static void resizePool(size_t count)
+{
+	if (count == numWorkers)
+	{
+		return;
+	}
+
+	stopPool();
+	poolGeneration = generation;
+
+	if ((workers = malloc(count * sizeof *workers)) != NULL)
+	{
+		while (numWorkers < count && pthread_create(&workers[numWorkers], NULL, worker, NULL) == 0)
+		{
+			numWorkers++;
+		}
+	}
+}
+#endif
+
+static void run(AParallelTask task, void* arg, size_t count)
+{
+	size_t i;
+
+#ifdef APARALLEL_THREADS
+	size_t pool = threads();
+
+	if (pool > 1 && count > 1 && pthread_mutex_trylock(&busy) == 0)
+	{
+		AParallelJob job;
+
+		job.task = task;
+		job.arg = arg;
+		job.count = count;
+		job.next = 0;
+
+		resizePool(pool - 1);
+
+		pthread_mutex_lock(&lock);
+		current = &job;
+		active = numWorkers;
+		generation++;
+		pthread_cond_broadcast(&started);
+		pthread_mutex_unlock(&lock);
+
+		/* If no worker could be started, this thread does all the work */
+		work(&job);
+
+		pthread_mutex_lock(&lock);
+
+		while (active > 0)
+		{
+			pthread_cond_wait(&done, &lock);
+		}
+
+		pthread_mutex_unlock(&lock);
+		pthread_mutex_unlock(&busy);
+		return;
+	}
+#endif
+
+	for (i = 0; i < count; i++)
+	{
+		task(arg, i);
+	}
+}
+
+static void shutdown(void)
+{
+#ifdef APARALLEL_THREADS
+	pthread_mutex_lock(&busy); /* Wait for the job which runs, if any */
+	stopPool();
+	pthread_mutex_unlock(&busy);
+#endif
+}
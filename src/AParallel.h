@@ -0,0 +1,93 @@
+/**
+ * @file AParallel.h
+ */
+
+#ifndef APARALLEL_H_
+#define APARALLEL_H_
+
+#include <stdlib.h>
+
+/**
+ * Parallel task function type
+ *
+ * The task function gets the argument passed to @link run AParallel->run()@endlink
+ * and the index of the piece of work to do. Tasks of different indices run at
+ * the same time on different threads, so they mustn't write the same memory.
+ */
+typedef void (*AParallelTask)(void* arg, size_t index);
+
+typedef struct __AParallel __AParallel;
+
+#ifdef DOXYGEN
+
+struct
+{
+	void   (*const setThreads)(size_t threads);                          /**< Set the number of threads */
+	size_t (*const threads)(void);                                       /**< Get the number of threads */
+	void   (*const run)(AParallelTask task, void* arg, size_t count);    /**< Run tasks in parallel */
+	void   (*const shutdown)(void);                                      /**< Stop the threads */
+} *AParallel;
+
+/**<
+ * Parallel execution
+ *
+ * AParallel is a pointer identifier which provides you with functions to split work
+ * across threads. Data structures use it for operations on many values at once, such as
+ * @link AVector::sort() sorting@endlink or @link AVector::map() mapping@endlink a vector.
+ *
+ * By default the work is split across as many threads as there are online CPUs. Set a
+ * different number of threads using @link setThreads AParallel->setThreads()@endlink.
+ * Where threads aren't supported (currently on Windows), all the work runs on the calling thread.
+ *
+ * The threads are started the first time work runs in parallel, and wait for more work after it's done,
+ * so running work doesn't pay for starting threads. Work is split across the threads for one caller at a
+ * time: work run by a task, or by another thread while some work runs, runs on its calling thread only.
+ * Stop the threads using @link shutdown AParallel->shutdown()@endlink before the program exits.
+ */
+
+/**
+ * @var void (*setThreads)(size_t threads)
+ * @param threads Number of threads, or 0 for the number of online CPUs
+ *
+ * Set the number of threads work is split across (including the calling thread). Setting 1 thread
+ * runs all the work on the calling thread. It may be called while work runs in parallel, which keeps
+ * its threads: the waiting threads are replaced by the new number of threads the next time work runs.
+ */
+
+/**
+ * @var size_t (*threads)(void)
+ * @return Number of threads work is split across
+ */
+
+/**
+ * @var void (*run)(AParallelTask task, void* arg, size_t count)
+ * @param task Task function
+ * @param arg Argument passed to each call to the task function
+ * @param count Number of pieces of work
+ *
+ * Call task(arg, index) for every index from 0 to count - 1, split across the threads,
+ * and return once all of them returned. The calling thread runs tasks too. Pieces are
+ * handed out to the threads one at a time, so pieces which take longer than others
+ * don't hold the rest of the work back.
+ */
+
+/**
+ * @var void (*shutdown)(void)
+ *
+ * Wait for the work which runs in parallel (if any) to finish, then stop the waiting threads
+ * and free them. Don't call it from a task. Work which runs afterwards starts the threads again.
+ */
+
+#endif
+
+struct __AParallel
+{
+	void   (*const setThreads)(size_t threads);
+	size_t (*const threads)(void);
+	void   (*const run)(AParallelTask task, void* arg, size_t count);
+	void   (*const shutdown)(void);
+};
+
+extern const __AParallel* AParallel;
+
+#endif /* APARALLEL_H_ */
@@ -0,0 +1,259 @@
+#include <stdlib.h>
+#include "AStructBase.h"
+#include "AInternal.h"
+#include "ASegmentedVector.h"
+
+static void**  ASegmentedVectorSlot(ASegmentedVector* self, size_t pos); /* Private functions */
+static size_t  ASegmentedVectorCapacity(ASegmentedVector* self);
+static void**  ASegmentedVectorAddBlock(ASegmentedVector* self);
+
+static void*   ASegmentedVectorCreate(ASegmentedVector* self, int numArgs, va_list args);
+static void    ASegmentedVectorClear(ASegmentedVector* self, AValueFree freeValue);
+static void    ASegmentedVectorDestroy(ASegmentedVector* self, AValueFree freeValue);
+static void**  ASegmentedVectorAppend(ASegmentedVector* self, void* value);
+static void*   ASegmentedVectorRemoveLast(ASegmentedVector* self);
+static void**  ASegmentedVectorSet(ASegmentedVector* self, size_t pos, void* value);
+static void*   ASegmentedVectorGet(ASegmentedVector* self, size_t pos);
+static void**  ASegmentedVectorAt(ASegmentedVector* self, size_t pos);
+static ASegmentedVector* ASegmentedVectorReserve(ASegmentedVector* self, size_t capacity);
+
+const ASegmentedVector ASegmentedVectorProto =
+{
+	ASegmentedVectorCreate, ASegmentedVectorClear, ASegmentedVectorDestroy, ASegmentedVectorAppend,
+	ASegmentedVectorRemoveLast, ASegmentedVectorSet, ASegmentedVectorGet, ASegmentedVectorAt,
+	ASegmentedVectorReserve
+};
+
+static const unsigned FIRST_BLOCK_BITS = 4; /* log2(ASEGMENTEDVECTOR_FIRST_BLOCK) */
+
+/*
+ * Create a new segmented vector
+ */
+static void* ASegmentedVectorCreate(ASegmentedVector* self, int numArgs, va_list args)
+{
+	self->numBlocks = 0;
+	self->size = 0;
+
+	return self;
+}
+
+/*
+ * Slot of the position in the blocks. Block k starts at position FIRST_BLOCK * (2^k - 1),
+ * so position + FIRST_BLOCK has its highest bit at index k + FIRST_BLOCK_BITS, and the
+ * rest of its bits are the offset in the block.
+ */
+static void** ASegmentedVectorSlot(ASegmentedVector* self, size_t pos)
+{
+	size_t n = pos + ASEGMENTEDVECTOR_FIRST_BLOCK;
+	unsigned bit = AHighestBit(n);
+
+	return &self->blocks[bit - FIRST_BLOCK_BITS][n - ((size_t)1 << bit)];
+}
+
+/*
+ * Number of items the allocated blocks can hold
+ */
+static size_t ASegmentedVectorCapacity(ASegmentedVector* self)
+{
+	return ASEGMENTEDVECTOR_FIRST_BLOCK * (((size_t)1 << self->numBlocks) - 1);
+}
+
+/*
+ * Allocate the next block, twice as large as the last one
+ */
+static void** ASegmentedVectorAddBlock(ASegmentedVector* self)
+{
+	void** block;
+
+	if (self->numBlocks == ASEGMENTEDVECTOR_MAX_BLOCKS ||
+	    (block = malloc(((size_t)ASEGMENTEDVECTOR_FIRST_BLOCK << self->numBlocks) * sizeof *block)) == NULL)
+	{
+		return NULL;
+	}
+
+	return self->blocks[self->numBlocks++] = block;
+}
+
+/**
+ * @fn void (*ASegmentedVector::clear)(ASegmentedVector* self, AValueFree freeValue)
+ * @param self The segmented vector
+ * @param freeValue Callback function to free the value pointer
+ *
+ * Clear the vector by removing all the values using freeValue (if it's not NULL).
+ * The blocks are kept for the values added afterwards.
+ */
+static void ASegmentedVectorClear(ASegmentedVector* self, AValueFree freeValue)
+{
+	size_t i;
+
+	if (self != NULL)
+	{
+		if (freeValue != NULL)
+		{
+			for (i = 0; i < self->size; i++)
+			{
+				freeValue(*ASegmentedVectorSlot(self, i));
+			}
+		}
+
+		self->size = 0;
+	}
+}
+
+/**
+ * @fn void (*ASegmentedVector::destroy)(ASegmentedVector* self, AValueFree freeValue)
+ * @param self The segmented vector
+ * @param freeValue Callback function to free the value pointer
+ *
+ * @link ASegmentedVector::clear() Clear@endlink the vector and free all
+ * of its storage. Any access to a destroyed vector is forbidden.
+ */
+static void ASegmentedVectorDestroy(ASegmentedVector* self, AValueFree freeValue)
+{
+	size_t i;
+
+	if (self != NULL)
+	{
+		ASegmentedVectorClear(self, freeValue);
+
+		for (i = 0; i < self->numBlocks; i++)
+		{
+			free(self->blocks[i]);
+		}
+
+		free(self);
+	}
+}
+
+/**
+ * @fn void** (*ASegmentedVector::append)(ASegmentedVector* self, void* value)
+ * @param self The segmented vector
+ * @param value The value
+ * @return Pointer to the value in the vector or NULL on error
+ *
+ * Append the value. If the blocks are full, a new block is added and no value is moved,
+ * so the returned pointer stays valid until the position is removed from the vector.
+ */
+static void** ASegmentedVectorAppend(ASegmentedVector* self, void* value)
+{
+	void** slot;
+
+	if (self == NULL || (self->size == ASegmentedVectorCapacity(self) && ASegmentedVectorAddBlock(self) == NULL))
+	{
+		return NULL;
+	}
+
+	slot = ASegmentedVectorSlot(self, self->size++);
+	*slot = value;
+
+	return slot;
+}
+
+/**
+ * @fn void* (*ASegmentedVector::removeLast)(ASegmentedVector* self)
+ * @param self The segmented vector
+ * @return The last value or NULL if the vector is empty
+ *
+ * Remove the last position from the vector. The blocks are kept for the values added afterwards.
+ */
+static void* ASegmentedVectorRemoveLast(ASegmentedVector* self)
+{
+	if (self != NULL && self->size > 0)
+	{
+		return *ASegmentedVectorSlot(self, --self->size);
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn void** (*ASegmentedVector::set)(ASegmentedVector* self, size_t pos, void* value)
+ * @param self The segmented vector
+ * @param pos Position index
+ * @param value The value
+ * @return Pointer to the value in the vector or NULL on error
+ *
+ * Set the value at the position. If position equals self->size then
+ * the call would be equivalent to ASegmentedVector::append().
+ */
+static void** ASegmentedVectorSet(ASegmentedVector* self, size_t pos, void* value)
+{
+	void** slot;
+
+	if (self != NULL)
+	{
+		if (pos == self->size)
+		{
+			return ASegmentedVectorAppend(self, value);
+		}
+
+		if (pos < self->size)
+		{
+			slot = ASegmentedVectorSlot(self, pos);
+			*slot = value;
+			return slot;
+		}
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn void* (*ASegmentedVector::get)(ASegmentedVector* self, size_t pos)
+ * @param self The segmented vector
+ * @param pos Position index
+ * @return The value at the position or NULL on error
+ */
+static void* ASegmentedVectorGet(ASegmentedVector* self, size_t pos)
+{
+	if (self != NULL && pos < self->size)
+	{
+		return *ASegmentedVectorSlot(self, pos);
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn void** (*ASegmentedVector::at)(ASegmentedVector* self, size_t pos)
+ * @param self The segmented vector
+ * @param pos Position index
+ * @return Pointer to the value at the position or NULL on error
+ *
+ * The pointer stays valid until the position is removed from the vector.
+ */
+static void** ASegmentedVectorAt(ASegmentedVector* self, size_t pos)
+{
+	if (self != NULL && pos < self->size)
+	{
+		return ASegmentedVectorSlot(self, pos);
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn ASegmentedVector* (*ASegmentedVector::reserve)(ASegmentedVector* self, size_t capacity)
+ * @param self The segmented vector
+ * @param capacity Number of items
+ * @return The vector or NULL on error
+ *
+ * Allocate the blocks needed to hold capacity items.
+ */
+static ASegmentedVector* ASegmentedVectorReserve(ASegmentedVector* self, size_t capacity)
+{
+	if (self == NULL)
+	{
+		return NULL;
+	}
+
+	while (ASegmentedVectorCapacity(self) < capacity)
+	{
+		if (ASegmentedVectorAddBlock(self) == NULL)
+		{
+			return NULL;
+		}
+	}
+
+	return self;
+}
@@ -0,0 +1,65 @@
+/**
+ * @file ASegmentedVector.h
+ */
+
+#ifndef ASEGMENTEDVECTOR_H_
+#define ASEGMENTEDVECTOR_H_
+
+#include <stdarg.h>
+#include "AStructBase.h"
+
+/**
+ * Number of items in the first block of a @link ASegmentedVector segmented vector@endlink (a power of 2)
+ */
+#define ASEGMENTEDVECTOR_FIRST_BLOCK 16
+
+/**
+ * Maximal number of blocks of a @link ASegmentedVector segmented vector@endlink, enough for any size
+ */
+#define ASEGMENTEDVECTOR_MAX_BLOCKS (8 * sizeof(size_t) - 4)
+
+typedef struct ASegmentedVector ASegmentedVector;
+
+/**
+ * Dynamic array with stable addresses
+ *
+ * This data structure is a dynamic array like AVector, which stores its values in blocks instead of
+ * a single array. The first block holds @ref ASEGMENTEDVECTOR_FIRST_BLOCK items and every following
+ * block is twice as large as the one before it, so a vector of n items has about log2(n) blocks.
+ *
+ * Growing the vector allocates a new block and never moves the values already in it. So the pointers
+ * ASegmentedVector::append() and ASegmentedVector::at() return stay valid as long as their position is
+ * in the vector, and can be kept as handles. Random access is constant, through a directory of blocks.
+ *
+ * The arguments passed to @link ANew AStruct->ANew()@endlink to create a new segmented vector are:
+ * @code AStruct->ANew(ASegmentedVector) @endcode
+ * No additional arguments should be passed.
+ *
+ * Example of creating a new segmented vector:
+ * @code
+ * ASegmentedVector* vector = AStruct->ANew(ASegmentedVector);
+ *
+ * void** handle = vector->append(vector, value);
+ * // ... append as many values as needed, *handle is still the value
+ * @endcode
+ */
+struct ASegmentedVector
+{
+	void*   (*const create)(ASegmentedVector* self, int numArgs, va_list args);  /*<  Default creator function called by AStruct->ANew() */
+	void    (*const clear)(ASegmentedVector* self, AValueFree freeValue);        /**< Clear all the vector */
+	void    (*const destroy)(ASegmentedVector* self, AValueFree freeValue);      /**< Clear and destroy the vector */
+	void**  (*const append)(ASegmentedVector* self, void* value);                /**< Append a value to the end of the vector */
+	void*   (*const removeLast)(ASegmentedVector* self);                         /**< Remove the last value of the vector */
+	void**  (*const set)(ASegmentedVector* self, size_t pos, void* value);       /**< Set a value at the position */
+	void*   (*const get)(ASegmentedVector* self, size_t pos);                    /**< Get the value at the position */
+	void**  (*const at)(ASegmentedVector* self, size_t pos);                     /**< Get a pointer to the value at the position */
+	ASegmentedVector* (*const reserve)(ASegmentedVector* self, size_t capacity); /**< Reserve capacity for a number of items */
+
+	void** blocks[ASEGMENTEDVECTOR_MAX_BLOCKS]; /*<  Directory of the blocks of values */
+	size_t numBlocks;                           /*<  Number of allocated blocks */
+	size_t size;                                /**< Number of items in the vector */
+};
+
+extern const ASegmentedVector ASegmentedVectorProto;
+
+#endif /* ASEGMENTEDVECTOR_H_ */
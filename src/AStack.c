@@ -9,10 +9,11 @@ static void    AStackDestroy(AStack* self, AValueFree freeValue);
 static void**  AStackPush(AStack* self, void* value);
 static void*   AStackTop(AStack* self);
 static void*   AStackPop(AStack* self);
+static void    AStackSetGrowth(AStack* self, AVectorGrowth growth);
 
 const AStack AStackProto =
 {
-	AStackCreate, AStackClear, AStackDestroy, AStackPush, AStackTop, AStackPop
+	AStackCreate, AStackClear, AStackDestroy, AStackPush, AStackTop, AStackPop, AStackSetGrowth
 };
 
 /*
@@ -129,3 +130,20 @@ static void* AStackPop(AStack* self)
 
 	return top;
 }
+
+/**
+ * @fn void (*AStack::setGrowth)(AStack* self, AVectorGrowth growth)
+ * @param self The stack
+ * @param growth The growth policy
+ *
+ * Set how the storage of the stack grows and shrinks (see AVectorGrowth). By default
+ * the storage doubles when it's full and never shrinks; set growth.shrinkBelow to give
+ * memory back after the stack was popped down.
+ */
+static void AStackSetGrowth(AStack* self, AVectorGrowth growth)
+{
+	if (self != NULL)
+	{
+		self->stack->growth = growth;
+	}
+}
@@ -36,6 +36,7 @@ struct AStack
 	void**  (*const push)(AStack* self, void* value);                  /**< Push a value onto the top of the stack */
 	void*   (*const top)(AStack* self);                                /**< Get the value on the top of the stack */
 	void*   (*const pop)(AStack* self);                                /**< Pop the top of the stack */
+	void    (*const setGrowth)(AStack* self, AVectorGrowth growth);    /**< Set the growth policy of the stack */
 
 	AVector* stack; /*<  The actual stack is a vector */
 	size_t size;    /**< The number of items on the stack */
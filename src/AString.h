@@ -0,0 +1,23 @@
+/**
+ * @file AString.h
+ */
+
+#ifndef ASTRING_H_
+#define ASTRING_H_
+
+#include <stdlib.h>
+
+/**
+ * Sized string.
+ *
+ * A string given by a pointer to its characters and its length, so it doesn't have to be
+ * scanned for its terminator (and may contain null characters). Use it as a key with
+ * @link astringHash AHash->astringHash@endlink and @link astringComp AComp->astringComp@endlink.
+ */
+typedef struct AString
+{
+	const char* data; /**< The characters */
+	size_t length;    /**< Number of characters */
+} AString;
+
+#endif /* ASTRING_H_ */
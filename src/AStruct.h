@@ -8,9 +8,18 @@
 #define ASTRUCT_H_
 
 #include "AList.h"
+#include "AUnrolledList.h"
 #include "AVector.h"
+#include "AArray.h"
+#include "ASegmentedVector.h"
+#include "AFileVector.h"
+#include "AColumnar.h"
+#include "ABitset.h"
+#include "ACowVector.h"
+#include "AParallel.h"
 #include "AStack.h"
 #include "AQueue.h"
 #include "AHashtable.h"
+#include "AFlatMap.h"
 
 #endif /* ASTRUCT_H_ */
@@ -22,6 +22,30 @@ typedef void* (*AValueFunc)(void *);
  */
 typedef void (*AValueFree)(void *);
 
+/**
+ * Value predicate function
+ *
+ * This function accepts a value pointer and returns non-zero
+ * if the value matches some condition, or zero otherwise.
+ */
+typedef int (*AValuePredicate)(void *);
+
+/**
+ * Value key function
+ *
+ * This function accepts a value pointer and returns an unsigned
+ * integer key of the value, which values are ordered by.
+ */
+typedef unsigned long long (*AValueKey)(const void *);
+
+/**
+ * Value combining function
+ *
+ * This function accepts two value pointers and returns
+ * a pointer to a value combining both of them.
+ */
+typedef void* (*AValueCombine)(void *, void *);
+
 #ifdef DOXYGEN
 
 struct
@@ -0,0 +1,505 @@
+#include <stdlib.h>
+#include <string.h> /* for memcpy(), memmove() */
+#include "AStructBase.h"
+#include "AUnrolledList.h"
+
+static AUnrolledListNode* AUnrolledListNewNode(AUnrolledList* self, AUnrolledListNode* prev, AUnrolledListNode* next); /* Private functions */
+static void    AUnrolledListFreeNode(AUnrolledList* self, AUnrolledListNode* node);
+static AUnrolledListNode* AUnrolledListFind(AUnrolledList* self, size_t pos, size_t* offset);
+static void*   AUnrolledListRemove(AUnrolledList* self, AUnrolledListNode* node, size_t offset);
+
+static void*   AUnrolledListCreate(AUnrolledList* self, int numArgs, va_list args);
+static void    AUnrolledListClear(AUnrolledList* self, AValueFree freeValue);
+static void    AUnrolledListDestroy(AUnrolledList* self, AValueFree freeValue);
+static AUnrolledList* AUnrolledListAppend(AUnrolledList* self, void* value);
+static void*   AUnrolledListLast(AUnrolledList* self);
+static void*   AUnrolledListPopLast(AUnrolledList* self);
+static AUnrolledList* AUnrolledListPrepend(AUnrolledList* self, void* value);
+static void*   AUnrolledListFirst(AUnrolledList* self);
+static void*   AUnrolledListPopFirst(AUnrolledList* self);
+static AUnrolledList* AUnrolledListInsertAt(AUnrolledList* self, size_t pos, void* value);
+static void*   AUnrolledListValueAt(AUnrolledList* self, size_t pos);
+static void*   AUnrolledListReplaceAt(AUnrolledList* self, size_t pos, void* value);
+static void*   AUnrolledListRemoveAt(AUnrolledList* self, size_t pos);
+static AUnrolledList* AUnrolledListCopy(AUnrolledList* self, AValueFunc copyValue);
+
+const AUnrolledList AUnrolledListProto =
+{
+	AUnrolledListCreate, AUnrolledListClear, AUnrolledListDestroy, AUnrolledListAppend, AUnrolledListLast,
+	AUnrolledListPopLast, AUnrolledListPrepend, AUnrolledListFirst, AUnrolledListPopFirst, AUnrolledListInsertAt,
+	AUnrolledListValueAt, AUnrolledListReplaceAt, AUnrolledListRemoveAt, AUnrolledListCopy
+};
+
+/*
+ * Create a new unrolled list
+ */
+static void* AUnrolledListCreate(AUnrolledList* self, int numArgs, va_list args)
+{
+	self->head = self->tail = NULL;
+	self->size = 0;
+
+	return self;
+}
+
+/*
+ * Allocate an empty node and link it between 'prev' and 'next' (either may be NULL at the ends of the list)
+ */
+static AUnrolledListNode* AUnrolledListNewNode(AUnrolledList* self, AUnrolledListNode* prev, AUnrolledListNode* next)
+{
+	AUnrolledListNode* node = malloc(sizeof *node);
+
+	if (node != NULL)
+	{
+		node->count = 0;
+		node->prev = prev;
+		node->next = next;
+
+		if (prev != NULL)
+		{
+			prev->next = node;
+		}
+		else
+		{
+			self->head = node;
+		}
+
+		if (next != NULL)
+		{
+			next->prev = node;
+		}
+		else
+		{
+			self->tail = node;
+		}
+	}
+
+	return node;
+}
+
+/*
+ * Unlink the node from the list and free it
+ */
+static void AUnrolledListFreeNode(AUnrolledList* self, AUnrolledListNode* node)
+{
+	if (node->prev != NULL)
+	{
+		node->prev->next = node->next;
+	}
+	else
+	{
+		self->head = node->next;
+	}
+
+	if (node->next != NULL)
+	{
+		node->next->prev = node->prev;
+	}
+	else
+	{
+		self->tail = node->prev;
+	}
+
+	free(node);
+}
+
+/*
+ * Find the node of the value at the position (which must be in the list), iterating from the nearest end,
+ * and the offset of the value in the node
+ */
+static AUnrolledListNode* AUnrolledListFind(AUnrolledList* self, size_t pos, size_t* offset)
+{
+	AUnrolledListNode* node;
+
+	if (pos < self->size / 2) /* from head */
+	{
+		for (node = self->head; pos >= node->count; node = node->next)
+		{
+			pos -= node->count;
+		}
+
+		*offset = pos;
+	}
+	else /* from tail, counting from the end */
+	{
+		for (node = self->tail, pos = self->size - 1 - pos; pos >= node->count; node = node->prev)
+		{
+			pos -= node->count;
+		}
+
+		*offset = node->count - 1 - pos;
+	}
+
+	return node;
+}
+
+/*
+ * Remove the value at the offset of the node. A node which is left empty is freed, and a node which is left
+ * less than half full is merged with a neighbor if they fit in one node.
+ */
+static void* AUnrolledListRemove(AUnrolledList* self, AUnrolledListNode* node, size_t offset)
+{
+	void* value = node->values[offset];
+	AUnrolledListNode* other;
+
+	memmove(node->values + offset, node->values + offset + 1, (node->count - offset - 1) * sizeof *node->values);
+	node->count--;
+	self->size--;
+
+	if (node->count == 0)
+	{
+		AUnrolledListFreeNode(self, node);
+	}
+	else if (node->count < AUNROLLEDLIST_VALUES / 2)
+	{
+		if ((other = node->next) != NULL && node->count + other->count <= AUNROLLEDLIST_VALUES) /* into this node */
+		{
+			memcpy(node->values + node->count, other->values, other->count * sizeof *node->values);
+			node->count += other->count;
+			AUnrolledListFreeNode(self, other);
+		}
+		else if ((other = node->prev) != NULL && node->count + other->count <= AUNROLLEDLIST_VALUES) /* into the previous one */
+		{
+			memcpy(other->values + other->count, node->values, node->count * sizeof *node->values);
+			other->count += node->count;
+			AUnrolledListFreeNode(self, node);
+		}
+	}
+
+	return value;
+}
+
+/**
+ * @fn void (*AUnrolledList::clear)(AUnrolledList* self, AValueFree freeValue)
+ * @param self The unrolled list
+ * @param freeValue Callback function to free the value pointer
+ *
+ * Clear the list by removing all the nodes and their values
+ * using freeValue to free the values (if it's not NULL).
+ */
+static void AUnrolledListClear(AUnrolledList* self, AValueFree freeValue)
+{
+	AUnrolledListNode* node = self->head;
+	size_t i;
+
+	while (node != NULL)
+	{
+		AUnrolledListNode* temp = node;
+		node = node->next;
+
+		if (freeValue != NULL)
+		{
+			for (i = 0; i < temp->count; i++)
+			{
+				freeValue(temp->values[i]);
+			}
+		}
+
+		free(temp);
+	}
+
+	self->head = self->tail = NULL;
+	self->size = 0;
+}
+
+/**
+ * @fn void (*AUnrolledList::destroy)(AUnrolledList* self, AValueFree freeValue)
+ * @param self The unrolled list
+ * @param freeValue Callback function to free the value pointer
+ *
+ * @link AUnrolledList::clear() Clear@endlink the list and free all
+ * of its storage. Any access to a destroyed list is forbidden.
+ */
+static void AUnrolledListDestroy(AUnrolledList* self, AValueFree freeValue)
+{
+	if (self != NULL)
+	{
+		AUnrolledListClear(self, freeValue);
+		free(self);
+	}
+}
+
+/**
+ * @fn AUnrolledList* (*AUnrolledList::append)(AUnrolledList* self, void* value)
+ * @param self The unrolled list
+ * @param value The value
+ * @return The list or NULL on error
+ *
+ * Append a value to the end of the list. A new node is added when the last one is full.
+ */
+static AUnrolledList* AUnrolledListAppend(AUnrolledList* self, void* value)
+{
+	AUnrolledListNode* node = self->tail;
+
+	if ((node == NULL || node->count == AUNROLLEDLIST_VALUES) &&
+	    (node = AUnrolledListNewNode(self, self->tail, NULL)) == NULL)
+	{
+		return NULL;
+	}
+
+	node->values[node->count++] = value;
+	self->size++;
+
+	return self;
+}
+
+/**
+ * @fn void* (*AUnrolledList::last)(AUnrolledList* self)
+ * @param self The unrolled list
+ * @return The last value or NULL on error
+ */
+static void* AUnrolledListLast(AUnrolledList* self)
+{
+	AUnrolledListNode* tail = self->tail;
+
+	return tail != NULL ? tail->values[tail->count - 1] : NULL;
+}
+
+/**
+ * @fn void* (*AUnrolledList::popLast)(AUnrolledList* self)
+ * @param self The unrolled list
+ * @return The last value or NULL on error
+ *
+ * Remove the last value from the list and return it.
+ */
+static void* AUnrolledListPopLast(AUnrolledList* self)
+{
+	AUnrolledListNode* tail = self->tail;
+
+	return tail != NULL ? AUnrolledListRemove(self, tail, tail->count - 1) : NULL;
+}
+
+/**
+ * @fn AUnrolledList* (*AUnrolledList::prepend)(AUnrolledList* self, void* value)
+ * @param self The unrolled list
+ * @param value The value
+ * @return The list or NULL on error
+ *
+ * Prepend a value to the start of the list. A new node is added when the first one is full.
+ */
+static AUnrolledList* AUnrolledListPrepend(AUnrolledList* self, void* value)
+{
+	AUnrolledListNode* node = self->head;
+
+	if ((node == NULL || node->count == AUNROLLEDLIST_VALUES) &&
+	    (node = AUnrolledListNewNode(self, NULL, self->head)) == NULL)
+	{
+		return NULL;
+	}
+
+	memmove(node->values + 1, node->values, node->count * sizeof *node->values);
+	node->values[0] = value;
+	node->count++;
+	self->size++;
+
+	return self;
+}
+
+/**
+ * @fn void* (*AUnrolledList::first)(AUnrolledList* self)
+ * @param self The unrolled list
+ * @return The first value or NULL on error
+ */
+static void* AUnrolledListFirst(AUnrolledList* self)
+{
+	AUnrolledListNode* head = self->head;
+
+	return head != NULL ? head->values[0] : NULL;
+}
+
+/**
+ * @fn void* (*AUnrolledList::popFirst)(AUnrolledList* self)
+ * @param self The unrolled list
+ * @return The first value or NULL on error
+ *
+ * Remove the first value from the list and return it.
+ */
+static void* AUnrolledListPopFirst(AUnrolledList* self)
+{
+	AUnrolledListNode* head = self->head;
+
+	return head != NULL ? AUnrolledListRemove(self, head, 0) : NULL;
+}
+
+/**
+ * @fn AUnrolledList* (*AUnrolledList::insertAt)(AUnrolledList* self, size_t pos, void* value)
+ * @param self The unrolled list
+ * @param pos Position index
+ * @param value The value
+ * @return The list or NULL on error
+ *
+ * Insert a value at a zero-based position in the list. If the node of the position is full,
+ * it's split in two nodes first.
+ */
+static AUnrolledList* AUnrolledListInsertAt(AUnrolledList* self, size_t pos, void* value)
+{
+	const size_t HALF = AUNROLLEDLIST_VALUES / 2;
+	AUnrolledListNode* node;
+	AUnrolledListNode* next;
+	size_t offset;
+
+	/* invalid positions */
+	if (pos > self->size)
+	{
+		return NULL;
+	}
+
+	if (pos == 0) /* first */
+	{
+		return AUnrolledListPrepend(self, value);
+	}
+	else if (pos == self->size) /* last */
+	{
+		return AUnrolledListAppend(self, value);
+	}
+
+	node = AUnrolledListFind(self, pos, &offset);
+
+	if (node->count == AUNROLLEDLIST_VALUES) /* move the upper half of the node to a new node */
+	{
+		if ((next = AUnrolledListNewNode(self, node, node->next)) == NULL)
+		{
+			return NULL;
+		}
+
+		next->count = node->count - HALF;
+		node->count = HALF;
+		memcpy(next->values, node->values + HALF, next->count * sizeof *node->values);
+
+		if (offset > HALF)
+		{
+			node = next;
+			offset -= HALF;
+		}
+	}
+
+	memmove(node->values + offset + 1, node->values + offset, (node->count - offset) * sizeof *node->values);
+	node->values[offset] = value;
+	node->count++;
+	self->size++;
+
+	return self;
+}
+
+/**
+ * @fn void* (*AUnrolledList::valueAt)(AUnrolledList* self, size_t pos)
+ * @param self The unrolled list
+ * @param pos Position index
+ * @return The value at the zero-based position or NULL on error
+ */
+static void* AUnrolledListValueAt(AUnrolledList* self, size_t pos)
+{
+	AUnrolledListNode* node;
+	size_t offset;
+
+	/* invalid positions */
+	if (pos >= self->size)
+	{
+		return NULL;
+	}
+
+	node = AUnrolledListFind(self, pos, &offset);
+
+	return node->values[offset];
+}
+
+/**
+ * @fn void* (*AUnrolledList::replaceAt)(AUnrolledList* self, size_t pos, void* value)
+ * @param self The unrolled list
+ * @param pos Position index
+ * @param value The new value
+ * @return The original value or NULL on error
+ *
+ * Replace the value at a zero-based position in the list with a new value and return the original one.
+ */
+static void* AUnrolledListReplaceAt(AUnrolledList* self, size_t pos, void* value)
+{
+	AUnrolledListNode* node;
+	size_t offset;
+	void* oldValue;
+
+	/* invalid positions */
+	if (pos >= self->size)
+	{
+		return NULL;
+	}
+
+	node = AUnrolledListFind(self, pos, &offset);
+	oldValue = node->values[offset];
+	node->values[offset] = value;
+
+	return oldValue;
+}
+
+/**
+ * @fn void* (*AUnrolledList::removeAt)(AUnrolledList* self, size_t pos)
+ * @param self The unrolled list
+ * @param pos Position index
+ * @return The value at the position or NULL on error
+ *
+ * Remove the value at a zero-based position and return it. A node which is left less
+ * than half full is merged with a neighbor if they fit in one node.
+ */
+static void* AUnrolledListRemoveAt(AUnrolledList* self, size_t pos)
+{
+	AUnrolledListNode* node;
+	size_t offset;
+
+	/* invalid positions */
+	if (pos >= self->size)
+	{
+		return NULL;
+	}
+
+	node = AUnrolledListFind(self, pos, &offset);
+
+	return AUnrolledListRemove(self, node, offset);
+}
+
+/**
+ * @fn AUnrolledList* (*AUnrolledList::copy)(AUnrolledList* self, AValueFunc copyValue)
+ * @param self The unrolled list
+ * @param copyValue Callback function that returns a pointer to a copy of the value
+ * @return A new copy of the list or NULL on error
+ *
+ * Create a new copy of the list and all of its values (if copyValue isn't NULL)
+ * and return the new list. The nodes of the copy are full. All the nodes are
+ * allocated before the values are copied, so no value is copied if the copy fails.
+ */
+static AUnrolledList* AUnrolledListCopy(AUnrolledList* self, AValueFunc copyValue)
+{
+	AUnrolledList* newList = AStruct->ANew(AUnrolledList);
+	AUnrolledListNode* node;
+	AUnrolledListNode* newNode;
+	size_t i, count;
+
+	if (newList == NULL)
+	{
+		return NULL;
+	}
+
+	for (count = 0; count < self->size; count += AUNROLLEDLIST_VALUES)
+	{
+		if (AUnrolledListNewNode(newList, newList->tail, NULL) == NULL)
+		{
+			AUnrolledListDestroy(newList, NULL);
+			return NULL;
+		}
+	}
+
+	for (node = self->head, newNode = newList->head; node != NULL; node = node->next)
+	{
+		for (i = 0; i < node->count; i++)
+		{
+			if (newNode->count == AUNROLLEDLIST_VALUES)
+			{
+				newNode = newNode->next;
+			}
+
+			newNode->values[newNode->count++] = copyValue != NULL ? copyValue(node->values[i]) : node->values[i];
+		}
+	}
+
+	newList->size = self->size;
+
+	return newList;
+}
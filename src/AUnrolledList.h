@@ -0,0 +1,89 @@
+/**
+ * @file AUnrolledList.h
+ */
+
+#ifndef AUNROLLEDLIST_H_
+#define AUNROLLEDLIST_H_
+
+#include <stdarg.h>
+#include "AStructBase.h"
+
+/**
+ * Number of values in each @link AUnrolledListNode unrolled list node@endlink (a node takes 2 cache lines)
+ */
+#define AUNROLLEDLIST_VALUES 13
+
+typedef struct AUnrolledListNode AUnrolledListNode;
+
+/**
+ * @link AUnrolledList Unrolled linked list@endlink node.
+ *
+ * The node contains an array of values, of which the first
+ * @link AUnrolledListNode::count count@endlink are in the list,
+ * and a pointer to the next and previous nodes. A pointer to NULL
+ * from either direction marks the end of the list.
+ */
+struct AUnrolledListNode
+{
+	AUnrolledListNode* prev;               /**< Previous node */
+	AUnrolledListNode* next;               /**< Next node */
+	size_t count;                          /**< Number of values in the node (never 0) */
+	void* values[AUNROLLEDLIST_VALUES];    /**< The values */
+};
+
+typedef struct AUnrolledList AUnrolledList;
+
+/**
+ * Unrolled linked list
+ *
+ * This data structure is a doubly linked list like AList, whose nodes hold up to @ref AUNROLLEDLIST_VALUES
+ * values each instead of one. Use it instead of AList when the list is mostly walked or accessed by position,
+ * rather than changed through pointers to its nodes: it reads far fewer nodes (and cache lines) to walk the
+ * list or get a value at a position, and takes less than half the memory per value.
+ *
+ * Appending, prepending and popping from both ends take constant time. Inserting or removing a value in the
+ * middle moves at most one node's values: a full node is split in two to make room for a value, and a node
+ * which is less than half full after a removal is merged with its next node if they fit in one node.
+ *
+ * The arguments passed to @link ANew AStruct->ANew()@endlink to create a new unrolled list are:
+ * @code AStruct->ANew(AUnrolledList) @endcode
+ * No additional arguments should be passed.
+ *
+ * Example of walking an unrolled list:
+ * @code
+ * AUnrolledList* list = AStruct->ANew(AUnrolledList);
+ * AUnrolledListNode* node;
+ * size_t i;
+ *
+ * list->append(list, value);
+ *
+ * for (node = list->head; node != NULL; node = node->next)
+ *     for (i = 0; i < node->count; i++)
+ *         use(node->values[i]);
+ * @endcode
+ */
+struct AUnrolledList
+{
+	void*          (*const create)(AUnrolledList* self, int numArgs, va_list args);       /*<  Default creator function called by AStruct->ANew() */
+	void           (*const clear)(AUnrolledList* self, AValueFree freeValue);             /**< Clear all the values in the list */
+	void           (*const destroy)(AUnrolledList* self, AValueFree freeValue);           /**< Destroy the list and clear it */
+	AUnrolledList* (*const append)(AUnrolledList* self, void* value);                     /**< Append a value to the end of the list */
+	void*          (*const last)(AUnrolledList* self);                                    /**< Get the last value in the list */
+	void*          (*const popLast)(AUnrolledList* self);                                 /**< Pop the last value from the list */
+	AUnrolledList* (*const prepend)(AUnrolledList* self, void* value);                    /**< Prepend a value to the start of the list */
+	void*          (*const first)(AUnrolledList* self);                                   /**< Get the first value in the list */
+	void*          (*const popFirst)(AUnrolledList* self);                                /**< Pop the first value from the list */
+	AUnrolledList* (*const insertAt)(AUnrolledList* self, size_t pos, void* value);       /**< Insert a value at a position in the list */
+	void*          (*const valueAt)(AUnrolledList* self, size_t pos);                     /**< Get the value at a position in the list */
+	void*          (*const replaceAt)(AUnrolledList* self, size_t pos, void* value);      /**< Replace the value at a position in the list */
+	void*          (*const removeAt)(AUnrolledList* self, size_t pos);                    /**< Remove the value at a position from the list */
+	AUnrolledList* (*const copy)(AUnrolledList* self, AValueFunc copyValue);              /**< Copy the entire list */
+
+	size_t size;               /**< Number of values in the list */
+	AUnrolledListNode* head;   /**< First node in the list */
+	AUnrolledListNode* tail;   /**< Last node in the list */
+};
+
+extern const AUnrolledList AUnrolledListProto;
+
+#endif /* AUNROLLEDLIST_H_ */
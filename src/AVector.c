@@ -1,9 +1,22 @@
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE /* for mremap() */
+#endif
 #include <stdlib.h>
-#include <string.h> /* for memcpy() */
+#include <string.h> /* for memcpy(), memmove() */
 #include "AStructBase.h"
+#include "AInternal.h"
+#include "AParallel.h"
 #include "AVector.h"
 
-static void**   AVectorMaybeExpand(AVector* self); /* Private function */
+static size_t   AVectorNextCapacity(const AVector* self, size_t capacity); /* Private functions */
+static void**   AVectorResize(AVector* self, size_t capacity);
+#ifdef A_MMAP
+static void**   AVectorMapStorage(AVector* self, size_t capacity);
+#endif
+static void     AVectorRelease(AVector* self);
+static void**   AVectorGrow(AVector* self, size_t size);
+static void**   AVectorMaybeExpand(AVector* self);
+static void     AVectorMaybeShrink(AVector* self);
 
 static void*    AVectorCreate(AVector* self, int numArgs, va_list args);
 static void     AVectorClear(AVector* self, AValueFree freeValue);
@@ -17,16 +30,47 @@ static void*    AVectorGet(AVector* self, size_t pos);
 static AVector* AVectorSubVector(AVector* self, size_t pos, size_t size, AValueFunc copyValue);
 static AVector* AVectorCopy(AVector* self, AValueFunc copyValue);
 static AVector* AVectorJoin(AVector* first, AVector* second);
+static void**   AVectorInsertRange(AVector* self, size_t pos, void* const* values, size_t count);
+static size_t   AVectorEraseRange(AVector* self, size_t pos, size_t count, AValueFree freeValue);
+static size_t   AVectorRemoveIf(AVector* self, AValuePredicate predicate, AValueFree freeValue);
+static void**   AVectorAppendArray(AVector* self, void* const* values, size_t count);
+static void**   AVectorAppendN(AVector* self, void* value, size_t count);
+static AVector* AVectorExtend(AVector* self, AVector* other);
+static AVector* AVectorReserve(AVector* self, size_t capacity);
+static AVector* AVectorShrinkToFit(AVector* self);
+static AVector* AVectorSort(AVector* self, AValueComp comp);
+static AVector* AVectorStableSort(AVector* self, AValueComp comp);
+static AVector* AVectorRadixSort(AVector* self, AValueKey key, size_t keyBytes);
+static size_t   AVectorLowerBound(AVector* self, const void* value, AValueComp comp);
+static size_t   AVectorUpperBound(AVector* self, const void* value, AValueComp comp);
+static void**   AVectorBinarySearch(AVector* self, const void* value, AValueComp comp);
+static void**   AVectorFind(AVector* self, const void* value, AValueComp comp);
+static size_t   AVectorIndexOf(AVector* self, const void* value, AValueComp comp);
+static size_t   AVectorCount(AVector* self, const void* value, AValueComp comp);
+static int      AVectorContains(AVector* self, const void* value, AValueComp comp);
+static AVector* AVectorMap(AVector* self, AValueFunc func);
+static AVector* AVectorTransform(AVector* self, AValueFunc func);
+static AVector* AVectorFilter(AVector* self, AValuePredicate predicate);
+static void*    AVectorReduce(AVector* self, AValueCombine combine, void* initial);
+static AVector* AVectorView(AVector* self, size_t pos, size_t size);
+static int      AVectorIsSorted(AVector* self, AValueComp comp);
 
 const AVector AVectorProto =
 {
 	AVectorCreate, AVectorClear, AVectorDestroy, AVectorAppend, AVectorInsert, AVectorReplace, AVectorRemove,
-	AVectorSet,	AVectorGet, AVectorSubVector, AVectorCopy, AVectorJoin
+	AVectorSet,	AVectorGet, AVectorSubVector, AVectorCopy, AVectorJoin, AVectorInsertRange, AVectorEraseRange,
+	AVectorRemoveIf, AVectorAppendArray, AVectorAppendN, AVectorExtend, AVectorReserve, AVectorShrinkToFit,
+	AVectorSort, AVectorStableSort, AVectorRadixSort, AVectorLowerBound, AVectorUpperBound, AVectorBinarySearch,
+	AVectorFind, AVectorIndexOf, AVectorCount, AVectorContains, AVectorMap, AVectorTransform, AVectorFilter,
+	AVectorReduce, AVectorView, AVectorIsSorted
 };
 
-const size_t DEFAULT_CAPACITY = 16;
 const size_t EXPAND_RATIO = 2;
 
+/* The mapped size and the owner of the values, which are only kept while they're outside the vector */
+#define AVectorMapped(self) ((self)->values != (self)->storage.local ? (self)->storage.outside.mapped : 0)
+#define AVectorOwner(self)  ((self)->values != (self)->storage.local ? (self)->storage.outside.owner : NULL)
+
 /*
  * Create a new vector
  */
@@ -35,17 +79,31 @@ void* AVectorCreate(AVector* self, int numArgs, va_list args)
 	/* If the user supplied an additional size argument, use it (in case it's valid) */
 	if (numArgs == 0 || (self->capacity = va_arg(args, int)) <= 0)
 	{
-		self->capacity = DEFAULT_CAPACITY; /* Otherwise use the default capacity */
+		self->capacity = AVECTOR_LOCAL_CAPACITY; /* Otherwise start with the storage inside the vector */
 	}
 
 	self->size = 0;
-	self->values = malloc(self->capacity * sizeof *self->values);
+	self->growth.factor = EXPAND_RATIO;
+	self->growth.chunk = 0;
+	self->growth.shrinkBelow = 0;
+	self->growth.mapAbove = 0;
+	self->growth.hugePages = 0;
 
-	if (self->values == NULL)
+	if (self->capacity <= AVECTOR_LOCAL_CAPACITY)
+	{
+		self->capacity = AVECTOR_LOCAL_CAPACITY;
+		self->values = self->storage.local;
+	}
+	else if ((self->values = malloc(self->capacity * sizeof *self->values)) == NULL)
 	{
 		free(self);
 		return NULL;
 	}
+	else
+	{
+		self->storage.outside.mapped = 0;
+		self->storage.outside.owner = NULL;
+	}
 
 	return self;
 }
@@ -56,12 +114,14 @@ void* AVectorCreate(AVector* self, int numArgs, va_list args)
  * @param freeValue Callback function to free the value pointer
  *
  * Clear the vector by removing all the values using freeValue (if it's not NULL).
+ * The values of a @link AVector::view() view@endlink belong to its vector, so
+ * freeValue is ignored for views.
  */
 static void AVectorClear(AVector* self, AValueFree freeValue)
 {
 	size_t i;
 
-	if (self != NULL && freeValue != NULL)
+	if (self != NULL && freeValue != NULL && AVectorOwner(self) == NULL)
 	{
 		for (i = 0; i < self->size; i++)
 		{
@@ -83,29 +143,211 @@ static void AVectorDestroy(AVector* self, AValueFree freeValue)
 	if (self != NULL)
 	{
 		AVectorClear(self, freeValue);
-		free(self->values);
+		AVectorRelease(self);
 		free(self);
 	}
 }
 
 /*
- * Expand the vector if it filled its capacity
+ * The capacity following 'capacity' by the growth policy of the vector
  */
-static void** AVectorMaybeExpand(AVector* self)
+static size_t AVectorNextCapacity(const AVector* self, size_t capacity)
+{
+	size_t next;
+
+	if (self->growth.chunk > 0 && capacity >= self->growth.chunk)
+	{
+		return capacity + self->growth.chunk;
+	}
+
+	next = (size_t)(capacity * self->growth.factor);
+	return next > capacity ? next : capacity + 1;
+}
+
+/*
+ * Free the storage of the values, unless it's inside the vector or borrowed by a view
+ */
+static void AVectorRelease(AVector* self)
+{
+	if (AVectorOwner(self) != NULL)
+	{
+		return;
+	}
+
+#ifdef A_MMAP
+	if (AVectorMapped(self) > 0)
+	{
+		munmap(self->values, self->storage.outside.mapped);
+		self->storage.outside.mapped = 0;
+		return;
+	}
+#endif
+
+	if (self->values != self->storage.local)
+	{
+		free(self->values);
+	}
+}
+
+/*
+ * Change the capacity of the vector to at least 'capacity' (which mustn't be less than its size).
+ * Capacities which fit inside the vector move the values there, capacities the growth policy
+ * says to map use mapped storage, and the rest use allocated storage. Views can't be resized.
+ */
+static void** AVectorResize(AVector* self, size_t capacity)
+{
+	void** newValues;
+
+	if (AVectorOwner(self) != NULL)
+	{
+		return NULL;
+	}
+
+	if (capacity <= AVECTOR_LOCAL_CAPACITY)
+	{
+		if (self->values != self->storage.local)
+		{
+			void* values[AVECTOR_LOCAL_CAPACITY]; /* The values overwrite the state of the storage */
+
+			memcpy(values, self->values, self->size * sizeof *values);
+			AVectorRelease(self);
+			memcpy(self->storage.local, values, self->size * sizeof *values);
+			self->values = self->storage.local;
+		}
+
+		self->capacity = AVECTOR_LOCAL_CAPACITY;
+		return self->values;
+	}
+
+#ifdef A_MMAP
+	if (self->growth.mapAbove > 0 && capacity >= self->growth.mapAbove)
+	{
+		return AVectorMapStorage(self, capacity);
+	}
+#endif
+
+	if (self->values == self->storage.local || AVectorMapped(self) > 0)
+	{
+		if ((newValues = malloc(capacity * sizeof *newValues)) != NULL)
+		{
+			memcpy(newValues, self->values, self->size * sizeof *newValues);
+			AVectorRelease(self);
+		}
+	}
+	else
+	{
+		newValues = realloc(self->values, capacity * sizeof *newValues);
+	}
+
+	if (newValues == NULL)
+	{
+		return NULL;
+	}
+
+	self->storage.outside.mapped = 0;
+	self->storage.outside.owner = NULL;
+	self->capacity = capacity;
+	return self->values = newValues;
+}
+
+/*
+ * Move the values to mapped storage of at least 'capacity' items. Mapped storage is resized by
+ * remapping its pages where the system can (so the values aren't copied, and the old and the new
+ * storage aren't both resident), and may be backed by transparent huge pages.
+ */
+#ifdef A_MMAP
+static void** AVectorMapStorage(AVector* self, size_t capacity)
+{
+	size_t pageSize = self->growth.hugePages ? A_HUGE_PAGE_SIZE : (size_t)sysconf(_SC_PAGESIZE);
+	size_t bytes = (capacity * sizeof *self->values + pageSize - 1) / pageSize * pageSize;
+	void* newValues;
+
+#ifdef A_MREMAP
+	if (AVectorMapped(self) > 0)
+	{
+		newValues = mremap(self->values, self->storage.outside.mapped, bytes, MREMAP_MAYMOVE);
+	}
+	else
+#endif
+	{
+		newValues = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+		if (newValues != MAP_FAILED)
+		{
+			memcpy(newValues, self->values, self->size * sizeof *self->values);
+			AVectorRelease(self);
+		}
+	}
+
+	if (newValues == MAP_FAILED)
+	{
+		return NULL;
+	}
+
+#ifdef MADV_HUGEPAGE
+	if (self->growth.hugePages)
+	{
+		madvise(newValues, bytes, MADV_HUGEPAGE); /* Only a hint, failing isn't an error */
+	}
+#endif
+
+	self->storage.outside.mapped = bytes;
+	self->storage.outside.owner = NULL;
+	self->capacity = bytes / sizeof *self->values;
+	return self->values = newValues;
+}
+#endif
+
+/*
+ * Expand the vector so it can hold 'size' values
+ */
+static void** AVectorGrow(AVector* self, size_t size)
 {
-	void** newValues = self->values;
+	size_t newCapacity = self->capacity;
 
-	if (self->size >= self->capacity)
+	if (size > newCapacity)
 	{
 		do
 		{
-			self->capacity *= EXPAND_RATIO;
-		} while (self->size >= self->capacity);
+			newCapacity = AVectorNextCapacity(self, newCapacity);
+		} while (size > newCapacity);
 
-		newValues = realloc(self->values, self->capacity * sizeof *newValues);
+		return AVectorResize(self, newCapacity);
 	}
 
-	return newValues != NULL ? self->values = newValues : NULL;
+	return self->values;
+}
+
+/*
+ * Expand the vector if it filled its capacity
+ */
+static void** AVectorMaybeExpand(AVector* self)
+{
+	return AVectorGrow(self, self->size + 1);
+}
+
+/*
+ * Shrink the vector if its growth policy says it's too empty. The new capacity leaves
+ * room to grow as much as the policy would have grown the vector from its current size.
+ */
+static void AVectorMaybeShrink(AVector* self)
+{
+	if (self->growth.shrinkBelow > 0 && self->capacity > AVECTOR_LOCAL_CAPACITY &&
+	    self->size < self->capacity * self->growth.shrinkBelow)
+	{
+		size_t newCapacity = AVectorNextCapacity(self, self->size);
+
+		if (newCapacity < AVECTOR_LOCAL_CAPACITY)
+		{
+			newCapacity = AVECTOR_LOCAL_CAPACITY;
+		}
+
+		/* Failing to shrink isn't an error, the vector just stays larger */
+		if (newCapacity < self->capacity)
+		{
+			AVectorResize(self, newCapacity);
+		}
+	}
 }
 
 /**
@@ -137,25 +379,7 @@ static void** AVectorAppend(AVector* self, void* value)
  */
 static void** AVectorInsert(AVector* self, size_t pos, void* value)
 {
-	if (self != NULL)
-	{
-		if (pos <= self->size && AVectorMaybeExpand(self) != NULL)
-		{
-			size_t i;
-
-			/* move all the items after pos one step forward */
-			for (i = self->size; i > pos; i--)
-			{
-				self->values[i] = self->values[i - 1];
-			}
-
-			self->size++;
-			self->values[pos] = value;
-			return &self->values[pos];
-		}
-	}
-
-	return NULL;
+	return AVectorInsertRange(self, pos, &value, 1);
 }
 
 /**
@@ -202,22 +426,16 @@ static void** AVectorReplace(AVector* self, size_t pos, void* value, AValueFree
  * @return The value at the position or NULL on error
  *
  * Remove the position from the vector by moving all
- * the items after the position one step backwards.
+ * the items after the position one step backwards. The vector may shrink
+ * afterwards, depending on its @link AVector::growth growth policy@endlink.
  */
 static void* AVectorRemove(AVector* self, size_t pos)
 {
 	if (self != NULL && pos < self->size)
 	{
 		void* value = self->values[pos];
-		size_t i;
 
-		self->size--;
-		for (i = pos; i < self->size; i++)
-		{
-			self->values[i] = self->values[i + 1];
-		}
-
-		return value;
+		return AVectorEraseRange(self, pos, 1, NULL) == 1 ? value : NULL;
 	}
 
 	return NULL;
@@ -278,6 +496,8 @@ static void* AVectorGet(AVector* self, size_t pos)
  *
  * Create a new vector starting from the position with the given size. If copyValue isn't
  * NULL, all the values from the vector will be copied using that function to the new sub-vector.
+ * Otherwise the value pointers are copied at once. Use AVector::view() to access a range of
+ * positions without copying it.
  */
 static AVector*	AVectorSubVector(AVector* self, size_t pos, size_t size, AValueFunc copyValue)
 {
@@ -293,11 +513,16 @@ static AVector*	AVectorSubVector(AVector* self, size_t pos, size_t size, AValueF
 			size_t k, end = pos + size;
 			subVector->size = size;
 
+			if (copyValue == NULL)
+			{
+				memcpy(subVector->values, self->values + pos, size * sizeof *self->values);
+				return subVector;
+			}
+
 			/* Copy all the items from the vector to the sub-vector */
 			for (k = 0; pos < end; pos++)
 			{
-				subVector->values[k++] = copyValue != NULL ?
-				copyValue(self->values[pos]) : self->values[pos];
+				subVector->values[k++] = copyValue(self->values[pos]);
 			}
 		}
 	}
@@ -325,23 +550,1551 @@ static AVector* AVectorCopy(AVector* self, AValueFunc copyValue)
  * @return The first vector or NULL on error
  *
  * Join the first vector with the second vector. The second vector
- * will be destroyed afterwards.
+ * will be destroyed afterwards. Use AVector::extend() to keep it.
  */
 static AVector*	AVectorJoin(AVector* first, AVector* second)
 {
-	if (first != NULL && second != NULL)
+	if (AVectorExtend(first, second) != NULL)
+	{
+		AVectorDestroy(second, NULL);
+		return first;
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn void** (*AVector::insertRange)(AVector* self, size_t pos, void* const* values, size_t count)
+ * @param self The vector
+ * @param pos Position index
+ * @param values Array of values
+ * @param count Number of values in the array
+ * @return Pointer to the first inserted value in the vector or NULL on error
+ *
+ * Insert the values before the position. All the items after the position
+ * are moved forward at once, so inserting many values costs a single move.
+ */
+static void** AVectorInsertRange(AVector* self, size_t pos, void* const* values, size_t count)
+{
+	if (self != NULL && pos <= self->size && AVectorGrow(self, self->size + count) != NULL)
+	{
+		memmove(self->values + pos + count, self->values + pos, (self->size - pos) * sizeof *self->values);
+		memcpy(self->values + pos, values, count * sizeof *values);
+		self->size += count;
+
+		return &self->values[pos];
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn size_t (*AVector::eraseRange)(AVector* self, size_t pos, size_t count, AValueFree freeValue)
+ * @param self The vector
+ * @param pos Position index of the first value to erase
+ * @param count Number of values to erase
+ * @param freeValue Callback function to free the value pointer
+ * @return Number of values erased
+ *
+ * Erase count values (or less, if the vector ends before) from the position and free them using
+ * freeValue (if it's not NULL). All the items after the range are moved backwards at once.
+ * The vector may shrink afterwards, depending on its @link AVector::growth growth policy@endlink.
+ * Nothing is erased from a @link AVector::view() view@endlink.
+ */
+static size_t AVectorEraseRange(AVector* self, size_t pos, size_t count, AValueFree freeValue)
+{
+	size_t i;
+
+	if (self == NULL || AVectorOwner(self) != NULL || pos >= self->size)
+	{
+		return 0;
+	}
+
+	if (count > self->size - pos)
+	{
+		count = self->size - pos;
+	}
+
+	if (freeValue != NULL)
+	{
+		for (i = pos; i < pos + count; i++)
+		{
+			freeValue(self->values[i]);
+		}
+	}
+
+	memmove(self->values + pos, self->values + pos + count, (self->size - pos - count) * sizeof *self->values);
+	self->size -= count;
+	AVectorMaybeShrink(self);
+
+	return count;
+}
+
+/**
+ * @fn size_t (*AVector::removeIf)(AVector* self, AValuePredicate predicate, AValueFree freeValue)
+ * @param self The vector
+ * @param predicate Callback function returning non-zero for values to remove
+ * @param freeValue Callback function to free the value pointer
+ * @return Number of values removed
+ *
+ * Remove all the values the predicate matches and free them using freeValue (if it's not NULL).
+ * The order of the remaining values is kept, and each of them is moved once at most.
+ * Nothing is removed from a @link AVector::view() view@endlink.
+ */
+static size_t AVectorRemoveIf(AVector* self, AValuePredicate predicate, AValueFree freeValue)
+{
+	size_t i, removed, kept = 0;
+
+	if (self == NULL || AVectorOwner(self) != NULL)
+	{
+		return 0;
+	}
+
+	for (i = 0; i < self->size; i++)
+	{
+		if (!predicate(self->values[i]))
+		{
+			self->values[kept++] = self->values[i];
+		}
+		else if (freeValue != NULL)
+		{
+			freeValue(self->values[i]);
+		}
+	}
+
+	removed = self->size - kept;
+	self->size = kept;
+	AVectorMaybeShrink(self);
+
+	return removed;
+}
+
+/**
+ * @fn void** (*AVector::appendArray)(AVector* self, void* const* values, size_t count)
+ * @param self The vector
+ * @param values Array of values
+ * @param count Number of values in the array
+ * @return Pointer to the first appended value in the vector or NULL on error
+ *
+ * Append all the values of the array. The vector is expanded (at most) once,
+ * and the values are copied at once.
+ */
+static void** AVectorAppendArray(AVector* self, void* const* values, size_t count)
+{
+	return self != NULL ? AVectorInsertRange(self, self->size, values, count) : NULL;
+}
+
+/**
+ * @fn void** (*AVector::appendN)(AVector* self, void* value, size_t count)
+ * @param self The vector
+ * @param value The value
+ * @param count Number of times to append the value
+ * @return Pointer to the first appended value in the vector or NULL on error
+ *
+ * Append the value count times. The vector is expanded (at most) once.
+ */
+static void** AVectorAppendN(AVector* self, void* value, size_t count)
+{
+	if (self != NULL && AVectorGrow(self, self->size + count) != NULL)
+	{
+		size_t i, start = self->size;
+
+		for (i = start; i < start + count; i++)
+		{
+			self->values[i] = value;
+		}
+
+		self->size += count;
+		return &self->values[start];
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn AVector* (*AVector::extend)(AVector* self, AVector* other)
+ * @param self The vector
+ * @param other The vector to append the values of
+ * @return The vector or NULL on error
+ *
+ * Append all the values of the other vector (which may be the vector itself).
+ * Unlike AVector::join(), the other vector isn't destroyed.
+ */
+static AVector* AVectorExtend(AVector* self, AVector* other)
+{
+	if (self != NULL && other != NULL && AVectorGrow(self, self->size + other->size) != NULL)
+	{
+		/* Copy the values from the other vector */
+		memcpy(self->values + self->size, other->values, other->size * sizeof *other->values);
+		self->size += other->size;
+		return self;
+	}
+
+	return NULL;
+}
+
+/**
+ * @fn AVector* (*AVector::reserve)(AVector* self, size_t capacity)
+ * @param self The vector
+ * @param capacity Number of items
+ * @return The vector or NULL on error
+ *
+ * Make sure the vector can hold capacity items without expanding.
+ */
+static AVector* AVectorReserve(AVector* self, size_t capacity)
+{
+	if (self != NULL && (capacity <= self->capacity || AVectorResize(self, capacity) != NULL))
 	{
-		size_t originalSize = first->size;
-		first->size += second->size;
+		return self;
+	}
+
+	return NULL;
+}
 
-		if (AVectorMaybeExpand(first) != NULL)
+/**
+ * @fn AVector* (*AVector::shrinkToFit)(AVector* self)
+ * @param self The vector
+ * @return The vector or NULL on error
+ *
+ * Free the storage of the vector which isn't used by its items. Vectors of up
+ * to @ref AVECTOR_LOCAL_CAPACITY items move them back inside the vector.
+ */
+static AVector* AVectorShrinkToFit(AVector* self)
+{
+	if (self != NULL)
+	{
+		if (self->size >= self->capacity || AVectorResize(self, self->size) != NULL)
 		{
-			/* Copy the values from the second vector */
-			memcpy(first->values + originalSize, second->values, second->size * sizeof *second->values);
-			AVectorDestroy(second, NULL);
-			return first;
+			return self;
 		}
 	}
 
 	return NULL;
 }
+
+/*
+ * Sorting
+ *
+ * Vectors are split into chunks which are sorted at the same time by different threads (see AParallel),
+ * and then the sorted chunks are merged in rounds, each merging pairs of runs twice as long as the last
+ * round. Every merge is split into parts of the output which are merged at the same time too, so all
+ * the threads work even in the last round. Small vectors are sorted by the calling thread only.
+ */
+
+/* Compare the values a and b by the descriptor 'comp' of kind 'kind' (see AKeysCompare()) */
+#define compareValues(a, b) AKeysCompare(comp, kind, a, b)
+
+static const size_t SORT_INSERTION_MAX = 16;      /* Runs up to this size are sorted by insertion */
+static const size_t SORT_PARALLEL_MIN = 1 << 15;  /* Vectors smaller than this are sorted by one thread */
+
+/* A sort split across threads */
+typedef struct AVectorSortJob
+{
+	void** values;
+	void** buffer;
+	size_t size;
+	size_t chunks;   /* Number of chunks sorted separately (a power of 2) */
+	size_t width;    /* Number of chunks in each run merged in this round */
+	size_t parts;    /* Number of parts each merge is split into */
+	void** source;   /* The runs merged in this round */
+	void** target;   /* The storage they're merged to */
+	AKeyComp comp;
+	int stable;
+} AVectorSortJob;
+
+static void AVectorInsertionSort(void** values, size_t size, const AKeyComp* comp, AKeyKind kind)
+{
+	size_t i, j;
+
+	for (i = 1; i < size; i++)
+	{
+		void* value = values[i];
+
+		for (j = i; j > 0 && compareValues(value, values[j - 1]) < 0; j--)
+		{
+			values[j] = values[j - 1];
+		}
+
+		values[j] = value;
+	}
+}
+
+static void AVectorSiftDown(void** values, size_t root, size_t size, const AKeyComp* comp, AKeyKind kind)
+{
+	void* value = values[root];
+	size_t child;
+
+	while ((child = 2 * root + 1) < size)
+	{
+		if (child + 1 < size && compareValues(values[child], values[child + 1]) < 0)
+		{
+			child++;
+		}
+
+		if (compareValues(value, values[child]) >= 0)
+		{
+			break;
+		}
+
+		values[root] = values[child];
+		root = child;
+	}
+
+	values[root] = value;
+}
+
+static void AVectorHeapSort(void** values, size_t size, const AKeyComp* comp, AKeyKind kind)
+{
+	size_t i;
+	void* value;
+
+	for (i = size / 2; i > 0; i--)
+	{
+		AVectorSiftDown(values, i - 1, size, comp, kind);
+	}
+
+	for (i = size; i > 1; i--)
+	{
+		value = values[0];
+		values[0] = values[i - 1];
+		values[i - 1] = value;
+		AVectorSiftDown(values, 0, i - 1, comp, kind);
+	}
+}
+
+/*
+ * Introsort: quicksort with a median of three pivot, which switches to heapsort when the
+ * recursion is too deep (so the worst case stays O(n log n)), and to insertion sort for short runs
+ */
+static void AVectorIntroSort(void** values, size_t size, const AKeyComp* comp, AKeyKind kind, unsigned depth)
+{
+	void* pivot;
+	void* value;
+	size_t i, j;
+
+	while (size > SORT_INSERTION_MAX)
+	{
+		if (depth-- == 0)
+		{
+			AVectorHeapSort(values, size, comp, kind);
+			return;
+		}
+
+		/* Order the first, middle and last values, so the first and the last stop the scans below */
+		if (compareValues(values[size / 2], values[0]) < 0)
+		{
+			value = values[0], values[0] = values[size / 2], values[size / 2] = value;
+		}
+
+		if (compareValues(values[size - 1], values[size / 2]) < 0)
+		{
+			value = values[size - 1], values[size - 1] = values[size / 2], values[size / 2] = value;
+
+			if (compareValues(values[size / 2], values[0]) < 0)
+			{
+				value = values[0], values[0] = values[size / 2], values[size / 2] = value;
+			}
+		}
+
+		pivot = values[size / 2];
+		i = 0;
+		j = size - 1;
+
+		for (;;)
+		{
+			while (compareValues(values[++i], pivot) < 0);
+			while (compareValues(pivot, values[--j]) < 0);
+
+			if (i >= j)
+			{
+				break;
+			}
+
+			value = values[i], values[i] = values[j], values[j] = value;
+		}
+
+		/* Values before i are not greater than the pivot and the rest are not less. Recurse into the smaller side. */
+		if (i < size - i)
+		{
+			AVectorIntroSort(values, i, comp, kind, depth);
+			values += i;
+			size -= i;
+		}
+		else
+		{
+			AVectorIntroSort(values + i, size - i, comp, kind, depth);
+			size = i;
+		}
+	}
+
+	AVectorInsertionSort(values, size, comp, kind);
+}
+
+/*
+ * Merge the sorted runs a and b to target. Equal values are taken from a first, so the merge is stable.
+ */
+static void AVectorMerge(void** a, size_t aSize, void** b, size_t bSize, void** target, const AKeyComp* comp, AKeyKind kind)
+{
+	void** aEnd = a + aSize;
+	void** bEnd = b + bSize;
+
+	while (a < aEnd && b < bEnd)
+	{
+		*target++ = compareValues(*b, *a) < 0 ? *b++ : *a++;
+	}
+
+	memcpy(target, a, (aEnd - a) * sizeof *a);
+	target += aEnd - a;
+	memcpy(target, b, (bEnd - b) * sizeof *b);
+}
+
+/*
+ * Number of values of the run a among the first k values of the stable merge of a and b
+ */
+static size_t AVectorMergeRank(void** a, size_t aSize, void** b, size_t bSize, size_t k, const AKeyComp* comp, AKeyKind kind)
+{
+	size_t low = k > bSize ? k - bSize : 0;
+	size_t high = k < aSize ? k : aSize;
+
+	while (low < high)
+	{
+		size_t i = low + (high - low) / 2;
+
+		/* a[i] is merged before b[k - i - 1], so more than i values of a are among the first k */
+		if (compareValues(b[k - i - 1], a[i]) >= 0)
+		{
+			low = i + 1;
+		}
+		else
+		{
+			high = i;
+		}
+	}
+
+	return low;
+}
+
+/*
+ * Bottom-up merge sort of the values, using a buffer of the same size
+ */
+static void AVectorMergeSort(void** values, void** buffer, size_t size, const AKeyComp* comp, AKeyKind kind)
+{
+	void** source = values;
+	void** target = buffer;
+	void** swap;
+	size_t i, width;
+
+	for (i = 0; i < size; i += SORT_INSERTION_MAX)
+	{
+		AVectorInsertionSort(values + i, size - i < SORT_INSERTION_MAX ? size - i : SORT_INSERTION_MAX, comp, kind);
+	}
+
+	for (width = SORT_INSERTION_MAX; width < size; width *= 2)
+	{
+		for (i = 0; i < size; i += 2 * width)
+		{
+			size_t middle = size - i < width ? size : i + width;
+			size_t end = size - i < 2 * width ? size : i + 2 * width;
+
+			AVectorMerge(source + i, middle - i, source + middle, end - middle, target + i, comp, kind);
+		}
+
+		swap = source, source = target, target = swap;
+	}
+
+	if (source != values)
+	{
+		memcpy(values, source, size * sizeof *values);
+	}
+}
+
+/*
+ * Sort the values comparing them by the descriptor of kind 'kind', merge sorting them using
+ * the buffer if the sort is stable
+ */
+static A_INLINE void AVectorSortRunKind(void** values, void** buffer, size_t size, const AKeyComp* comp,
+                                        AKeyKind kind, int stable)
+{
+	if (stable)
+	{
+		AVectorMergeSort(values, buffer, size, comp, kind);
+	}
+	else
+	{
+		AVectorIntroSort(values, size, comp, kind, 2 * AHighestBit(size | 1));
+	}
+}
+
+/*
+ * Sort the values (see AVectorSortRunKind()). The built-in kinds of values get their own
+ * copies of the sort, so values are compared inline.
+ */
+static void AVectorSortRun(void** values, void** buffer, size_t size, const AKeyComp* comp, int stable)
+{
+	switch (comp->kind)
+	{
+		case AKeyInt32:   AVectorSortRunKind(values, buffer, size, comp, AKeyInt32, stable); break;
+		case AKeyInt64:   AVectorSortRunKind(values, buffer, size, comp, AKeyInt64, stable); break;
+		case AKeyPointer: AVectorSortRunKind(values, buffer, size, comp, AKeyPointer, stable); break;
+		case AKeyString:  AVectorSortRunKind(values, buffer, size, comp, AKeyString, stable); break;
+		case AKeyBytes:   AVectorSortRunKind(values, buffer, size, comp, AKeyBytes, stable); break;
+		case AKeyAString: AVectorSortRunKind(values, buffer, size, comp, AKeyAString, stable); break;
+		default:          AVectorSortRunKind(values, buffer, size, comp, AKeyCustom, stable); break;
+	}
+}
+
+/*
+ * Sort one chunk of the vector
+ */
+static void AVectorSortChunk(void* arg, size_t index)
+{
+	AVectorSortJob* job = arg;
+	size_t start = ASplit(job->size, index, job->chunks);
+	size_t size = ASplit(job->size, index + 1, job->chunks) - start;
+
+	AVectorSortRun(job->values + start, job->buffer + start, size, &job->comp, job->stable);
+}
+
+/*
+ * Merge one part of the output of a merge of two runs, comparing the values by the descriptor of kind 'kind'
+ */
+static A_INLINE void AVectorSortMergePartKind(AVectorSortJob* job, size_t index, AKeyKind kind)
+{
+	size_t pair = index / job->parts, part = index % job->parts;
+	size_t start = ASplit(job->size, 2 * pair * job->width, job->chunks);
+	size_t middle = ASplit(job->size, (2 * pair + 1) * job->width, job->chunks);
+	size_t end = ASplit(job->size, (2 * pair + 2) * job->width, job->chunks);
+	void** a = job->source + start;
+	void** b = job->source + middle;
+	size_t aSize = middle - start, bSize = end - middle;
+
+	size_t first = ASplit(aSize + bSize, part, job->parts);
+	size_t last = ASplit(aSize + bSize, part + 1, job->parts);
+	size_t aFirst = AVectorMergeRank(a, aSize, b, bSize, first, &job->comp, kind);
+	size_t aLast = AVectorMergeRank(a, aSize, b, bSize, last, &job->comp, kind);
+
+	AVectorMerge(a + aFirst, aLast - aFirst, b + (first - aFirst), (last - aLast) - (first - aFirst),
+	             job->target + start + first, &job->comp, kind);
+}
+
+/*
+ * Merge one part of the output of a merge of two runs (see AVectorSortMergePartKind())
+ */
+static void AVectorSortMergePart(void* arg, size_t index)
+{
+	AVectorSortJob* job = arg;
+
+	switch (job->comp.kind)
+	{
+		case AKeyInt32:   AVectorSortMergePartKind(job, index, AKeyInt32); break;
+		case AKeyInt64:   AVectorSortMergePartKind(job, index, AKeyInt64); break;
+		case AKeyPointer: AVectorSortMergePartKind(job, index, AKeyPointer); break;
+		case AKeyString:  AVectorSortMergePartKind(job, index, AKeyString); break;
+		case AKeyBytes:   AVectorSortMergePartKind(job, index, AKeyBytes); break;
+		case AKeyAString: AVectorSortMergePartKind(job, index, AKeyAString); break;
+		default:          AVectorSortMergePartKind(job, index, AKeyCustom); break;
+	}
+}
+
+/*
+ * Sort the vector using all the threads, or using the calling thread if it's small
+ */
+static AVector* AVectorSortValues(AVector* self, AValueComp comp, int stable)
+{
+	AVectorSortJob job;
+	size_t threads = AParallel->threads();
+	void** swap;
+
+	if (self == NULL || comp == NULL)
+	{
+		return NULL;
+	}
+
+	job.comp = AComp->describe(comp);
+
+	if (self->size < 2)
+	{
+		return self;
+	}
+
+	/* Small vectors are sorted on this thread, and an unstable sort of them doesn't need a buffer */
+	if (!stable && (self->size < SORT_PARALLEL_MIN || threads < 2))
+	{
+		AVectorSortRun(self->values, NULL, self->size, &job.comp, 0);
+		return self;
+	}
+
+	if ((job.buffer = malloc(self->size * sizeof *job.buffer)) == NULL)
+	{
+		if (stable)
+		{
+			return NULL;
+		}
+
+		AVectorSortRun(self->values, NULL, self->size, &job.comp, 0);
+		return self;
+	}
+
+	job.values = self->values;
+	job.size = self->size;
+	job.stable = stable;
+	job.chunks = 1;
+
+	if (self->size >= SORT_PARALLEL_MIN)
+	{
+		while (job.chunks < threads)
+		{
+			job.chunks *= 2;
+		}
+	}
+
+	AParallel->run(AVectorSortChunk, &job, job.chunks);
+
+	job.source = job.values;
+	job.target = job.buffer;
+
+	for (job.width = 1; job.width < job.chunks; job.width *= 2)
+	{
+		size_t pairs = job.chunks / (2 * job.width);
+
+		job.parts = threads > pairs ? threads / pairs : 1;
+		AParallel->run(AVectorSortMergePart, &job, pairs * job.parts);
+		swap = job.source, job.source = job.target, job.target = swap;
+	}
+
+	if (job.source != job.values)
+	{
+		memcpy(job.values, job.source, job.size * sizeof *job.values);
+	}
+
+	free(job.buffer);
+	return self;
+}
+
+/**
+ * @fn AVector* (*AVector::sort)(AVector* self, AValueComp comp)
+ * @param self The vector
+ * @param comp Comparison function of the values
+ * @return The vector or NULL on error
+ *
+ * Sort the values in place in ascending order by the comparison function. Equal values may
+ * change their order (see AVector::stableSort()). Large vectors are sorted by several threads
+ * (see AParallel), each sorting a chunk of the vector using introsort before the chunks are merged.
+ */
+static AVector* AVectorSort(AVector* self, AValueComp comp)
+{
+	return AVectorSortValues(self, comp, 0);
+}
+
+/**
+ * @fn AVector* (*AVector::stableSort)(AVector* self, AValueComp comp)
+ * @param self The vector
+ * @param comp Comparison function of the values
+ * @return The vector or NULL on error
+ *
+ * Sort the values in place in ascending order by the comparison function, keeping equal values
+ * in the order they were in. The values are merge sorted, by several threads for large vectors
+ * (see AParallel), using temporary storage of the size of the vector.
+ */
+static AVector* AVectorStableSort(AVector* self, AValueComp comp)
+{
+	return AVectorSortValues(self, comp, 1);
+}
+
+/*
+ * Radix sorting
+ *
+ * The keys are sorted a byte at a time from the lowest byte, each pass moving the keys and the values
+ * stably by the byte into the other of two arrays. The keys are extracted once, into an array kept
+ * alongside the values. Every pass counts the bytes of each chunk of the arrays at the same time on
+ * different threads, and then the chunks are moved at the same time too, each to the positions which
+ * follow the ones of the chunks before it. Passes of bytes all the keys share don't move anything and
+ * are skipped, using the counts of all the bytes of the keys taken when they're extracted.
+ */
+
+#define RADIX 256
+
+/* A radix sort split across threads */
+typedef struct AVectorRadixJob
+{
+	void** values;                /* The values and their keys before a pass */
+	unsigned long long* keys;
+	void** targetValues;          /* The values and their keys after a pass */
+	unsigned long long* targetKeys;
+	size_t size;
+	size_t chunks;
+	AValueKey key;
+	size_t keyBytes;
+	unsigned shift;               /* Shift of the byte of the pass */
+	size_t (*counts)[RADIX];      /* Counts of the bytes of the keys (of every byte, per chunk) */
+	size_t (*offsets)[RADIX];     /* Counts of the byte of the pass per chunk, and then its positions */
+} AVectorRadixJob;
+
+/*
+ * Extract the keys of one chunk and count all their bytes
+ */
+static void AVectorRadixKeys(void* arg, size_t index)
+{
+	AVectorRadixJob* job = arg;
+	size_t (*counts)[RADIX] = job->counts + index * job->keyBytes;
+	size_t i, b, end = ASplit(job->size, index + 1, job->chunks);
+
+	for (i = ASplit(job->size, index, job->chunks); i < end; i++)
+	{
+		unsigned long long key = job->key(job->values[i]);
+
+		job->keys[i] = key;
+
+		for (b = 0; b < job->keyBytes; b++)
+		{
+			counts[b][key >> 8 * b & (RADIX - 1)]++;
+		}
+	}
+}
+
+/*
+ * Count the byte of the pass in one chunk
+ */
+static void AVectorRadixCount(void* arg, size_t index)
+{
+	AVectorRadixJob* job = arg;
+	size_t* counts = job->offsets[index];
+	size_t i, end = ASplit(job->size, index + 1, job->chunks);
+
+	memset(counts, 0, RADIX * sizeof *counts);
+
+	for (i = ASplit(job->size, index, job->chunks); i < end; i++)
+	{
+		counts[job->keys[i] >> job->shift & (RADIX - 1)]++;
+	}
+}
+
+/*
+ * Move the keys and the values of one chunk to their positions by the byte of the pass
+ */
+static void AVectorRadixMove(void* arg, size_t index)
+{
+	AVectorRadixJob* job = arg;
+	size_t* offsets = job->offsets[index];
+	size_t i, end = ASplit(job->size, index + 1, job->chunks);
+
+	for (i = ASplit(job->size, index, job->chunks); i < end; i++)
+	{
+		size_t position = offsets[job->keys[i] >> job->shift & (RADIX - 1)]++;
+
+		job->targetKeys[position] = job->keys[i];
+		job->targetValues[position] = job->values[i];
+	}
+}
+
+/**
+ * @fn AVector* (*AVector::radixSort)(AVector* self, AValueKey key, size_t keyBytes)
+ * @param self The vector
+ * @param key Callback function returning the key of a value
+ * @param keyBytes Number of low bytes of the keys to sort by (1 to 8, such as 4 for 32 bit keys)
+ * @return The vector or NULL on error
+ *
+ * Sort the values in place in ascending order of their unsigned integer keys, keeping values
+ * with equal keys in the order they were in. The sort takes linear time: key is called once for
+ * each value, and the values are moved once for every byte of the keys which isn't the same in
+ * all of them. Large vectors are sorted by several threads (see AParallel). The sort uses temporary
+ * storage of twice the size of the vector, and another array of the keys.
+ *
+ * Example of sorting records by their 32 bit timestamps:
+ * @code
+ * static unsigned long long timestampKey(const void* record)
+ * {
+ *     return ((const struct Record *)record)->timestamp;
+ * }
+ *
+ * vector->radixSort(vector, timestampKey, 4);
+ * @endcode
+ */
+static AVector* AVectorRadixSort(AVector* self, AValueKey key, size_t keyBytes)
+{
+	AVectorRadixJob job;
+	size_t threads = AParallel->threads();
+	size_t b, c, d, position;
+	void** swapValues;
+	unsigned long long* swapKeys;
+	unsigned long long* keys;
+	void** values;
+
+	if (self == NULL || key == NULL || keyBytes == 0 || keyBytes > sizeof(unsigned long long))
+	{
+		return NULL;
+	}
+
+	if (self->size < 2)
+	{
+		return self;
+	}
+
+	job.values = self->values;
+	job.size = self->size;
+	job.chunks = self->size >= SORT_PARALLEL_MIN && threads > 1 ? threads : 1;
+	job.key = key;
+	job.keyBytes = keyBytes;
+	job.keys = keys = malloc(2 * self->size * sizeof *keys);
+	job.targetKeys = keys + self->size;
+	job.targetValues = values = malloc(self->size * sizeof *values);
+	job.counts = calloc(job.chunks * keyBytes, sizeof *job.counts);
+	job.offsets = malloc(job.chunks * sizeof *job.offsets);
+
+	if (keys == NULL || values == NULL || job.counts == NULL || job.offsets == NULL)
+	{
+		free(keys);
+		free(values);
+		free(job.counts);
+		free(job.offsets);
+		return NULL;
+	}
+
+	AParallel->run(AVectorRadixKeys, &job, job.chunks);
+
+	for (b = 0; b < keyBytes; b++)
+	{
+		/* Skip the pass if all the keys have the same byte */
+		for (d = 0; d < RADIX; d++)
+		{
+			size_t count = 0;
+
+			for (c = 0; c < job.chunks; c++)
+			{
+				count += job.counts[c * keyBytes + b][d];
+			}
+
+			if (count > 0)
+			{
+				break;
+			}
+		}
+
+		for (c = 0, position = 0; c < job.chunks; c++)
+		{
+			position += job.counts[c * keyBytes + b][d];
+		}
+
+		if (position == job.size)
+		{
+			continue;
+		}
+
+		job.shift = 8 * (unsigned)b;
+		AParallel->run(AVectorRadixCount, &job, job.chunks);
+
+		/* The positions of each byte follow the smaller bytes, and in each byte the chunks before */
+		for (d = 0, position = 0; d < RADIX; d++)
+		{
+			for (c = 0; c < job.chunks; c++)
+			{
+				size_t count = job.offsets[c][d];
+
+				job.offsets[c][d] = position;
+				position += count;
+			}
+		}
+
+		AParallel->run(AVectorRadixMove, &job, job.chunks);
+
+		swapValues = job.values, job.values = job.targetValues, job.targetValues = swapValues;
+		swapKeys = job.keys, job.keys = job.targetKeys, job.targetKeys = swapKeys;
+	}
+
+	if (job.values != self->values)
+	{
+		memcpy(self->values, job.values, job.size * sizeof *job.values);
+	}
+
+	free(keys);
+	free(values);
+	free(job.counts);
+	free(job.offsets);
+	return self;
+}
+
+/*
+ * Binary search
+ *
+ * The searches halve the range without branching on the comparisons: the next range is picked
+ * by a conditional move, so the searches don't pay for branches the CPU mispredicts half the time.
+ * Values of the built-in kinds (see AComp->describe()) are compared inline.
+ */
+
+/*
+ * The first position whose value is greater than value if 'upper' is 1, or isn't less than value
+ * if it's 0, comparing by the descriptor of kind 'kind'. The values of the vector are always the
+ * first argument of the comparison, so the upper bound skips the values which compare below 1.
+ */
+static A_INLINE size_t AVectorBoundKind(AVector* self, const void* value, const AKeyComp* comp,
+                                        AKeyKind kind, int upper)
+{
+	void** base;
+	size_t size, half;
+
+	for (base = self->values, size = self->size; size > 1; size -= half)
+	{
+		half = size / 2;
+		base = compareValues(base[half], value) < upper ? base + half : base;
+	}
+
+	return (base - self->values) + (compareValues(*base, value) < upper);
+}
+
+/*
+ * Binary search of a non-empty vector (see AVectorBoundKind())
+ */
+static size_t AVectorBound(AVector* self, const void* value, const AKeyComp* comp, int upper)
+{
+	switch (comp->kind)
+	{
+		case AKeyInt32:   return AVectorBoundKind(self, value, comp, AKeyInt32, upper);
+		case AKeyInt64:   return AVectorBoundKind(self, value, comp, AKeyInt64, upper);
+		case AKeyPointer: return AVectorBoundKind(self, value, comp, AKeyPointer, upper);
+		case AKeyString:  return AVectorBoundKind(self, value, comp, AKeyString, upper);
+		case AKeyBytes:   return AVectorBoundKind(self, value, comp, AKeyBytes, upper);
+		case AKeyAString: return AVectorBoundKind(self, value, comp, AKeyAString, upper);
+		default:          return AVectorBoundKind(self, value, comp, AKeyCustom, upper);
+	}
+}
+
+/**
+ * @fn size_t (*AVector::lowerBound)(AVector* self, const void* value, AValueComp comp)
+ * @param self The vector
+ * @param value The value to search for
+ * @param comp Comparison function the vector is sorted by
+ * @return The first position whose value isn't less than value, or self->size if there's none
+ *
+ * Search a vector sorted by the comparison function (such as by AVector::sort()) in O(log n) time.
+ * comp is passed a value of the vector as its first argument and value as its second.
+ */
+static size_t AVectorLowerBound(AVector* self, const void* value, AValueComp comp)
+{
+	AKeyComp desc;
+
+	if (self == NULL || self->size == 0)
+	{
+		return 0;
+	}
+
+	desc = AComp->describe(comp);
+	return AVectorBound(self, value, &desc, 0);
+}
+
+/**
+ * @fn size_t (*AVector::upperBound)(AVector* self, const void* value, AValueComp comp)
+ * @param self The vector
+ * @param value The value to search for
+ * @param comp Comparison function the vector is sorted by
+ * @return The first position whose value is greater than value, or self->size if there's none
+ *
+ * Search a vector sorted by the comparison function in O(log n) time. comp is passed a value of the
+ * vector as its first argument and value as its second, as in AVector::lowerBound(), so value may be
+ * a key of a different type than the values. The values equal to value are the ones from
+ * AVector::lowerBound() to AVector::upperBound().
+ */
+static size_t AVectorUpperBound(AVector* self, const void* value, AValueComp comp)
+{
+	AKeyComp desc;
+
+	if (self == NULL || self->size == 0)
+	{
+		return 0;
+	}
+
+	desc = AComp->describe(comp);
+	return AVectorBound(self, value, &desc, 1);
+}
+
+/**
+ * @fn void** (*AVector::binarySearch)(AVector* self, const void* value, AValueComp comp)
+ * @param self The vector
+ * @param value The value to search for
+ * @param comp Comparison function the vector is sorted by
+ * @return Pointer to the first value equal to value in the vector, or NULL if there's none
+ *
+ * Search a vector sorted by the comparison function in O(log n) time (see AVector::lowerBound()).
+ */
+static void** AVectorBinarySearch(AVector* self, const void* value, AValueComp comp)
+{
+	AKeyComp desc;
+	size_t pos;
+
+	if (self == NULL || self->size == 0)
+	{
+		return NULL;
+	}
+
+	desc = AComp->describe(comp);
+	pos = AVectorBound(self, value, &desc, 0);
+
+	if (pos < self->size && AKeysCompare(&desc, desc.kind, self->values[pos], value) == 0)
+	{
+		return &self->values[pos];
+	}
+
+	return NULL;
+}
+
+/*
+ * Linear search
+ *
+ * Values are matched by the kind of the comparison function (see AComp->describe()), in a loop the
+ * comparison of the kind is inlined into. Pointers are matched 4 or 2 at a time using SIMD instructions
+ * when the CPU supports them, which is how values are matched without a comparison function too.
+ */
+
+#if defined(A_X86_SIMD) && defined(__x86_64__)
+#define AVECTOR_SIMD
+#endif
+
+#ifdef AVECTOR_SIMD
+/*
+ * Position of the first of the values from start which is the pointer value, or size if there's none
+ */
+A_TARGET("sse2") static size_t AVectorScanSSE2(void* const* values, size_t start, size_t size, const void* value)
+{
+	__m128i pattern = _mm_set1_epi64x((long long)(size_t)value);
+	size_t i;
+
+	for (i = start; i + 2 <= size; i += 2)
+	{
+		/* SSE2 compares 32 bits at a time, so a pointer matches if both of its halves match */
+		unsigned mask = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(
+		                _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i *)(values + i)), pattern)));
+
+		mask &= mask >> 1 & 5;
+
+		if (mask != 0)
+		{
+			return i + ACountTrailingZeros(mask) / 2;
+		}
+	}
+
+	return i < size && values[i] != value ? size : i;
+}
+
+/*
+ * AVectorScanSSE2() 4 values at a time
+ */
+A_TARGET("avx2") static size_t AVectorScanAVX2(void* const* values, size_t start, size_t size, const void* value)
+{
+	__m256i pattern = _mm256_set1_epi64x((long long)(size_t)value);
+	size_t i;
+
+	for (i = start; i + 4 <= size; i += 4)
+	{
+		unsigned mask = (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(
+		                _mm256_cmpeq_epi64(_mm256_loadu_si256((const __m256i *)(values + i)), pattern)));
+
+		if (mask != 0)
+		{
+			return i + ACountTrailingZeros(mask);
+		}
+	}
+
+	return AVectorScanSSE2(values, i, size, value);
+}
+#endif /* AVECTOR_SIMD */
+
+static size_t AVectorScan(void* const* values, size_t start, size_t size, const void* value)
+{
+	size_t i;
+
+#ifdef AVECTOR_SIMD
+	if (A_CPU_SUPPORTS("avx2"))
+	{
+		return AVectorScanAVX2(values, start, size, value);
+	}
+
+	if (A_CPU_SUPPORTS("sse2"))
+	{
+		return AVectorScanSSE2(values, start, size, value);
+	}
+#endif
+
+	for (i = start; i < size && values[i] != value; i++);
+
+	return i;
+}
+
+/*
+ * Position of the first of the values from start equal to value by the comparison function
+ * of the kind, or self->size if there's none
+ */
+static A_INLINE size_t AVectorMatchKind(AVector* self, size_t start, const void* value,
+                                        const AKeyComp* comp, AKeyKind kind)
+{
+	size_t i;
+
+	for (i = start; i < self->size && !AKeysEqual(comp, kind, self->values[i], value); i++);
+
+	return i;
+}
+
+static size_t AVectorMatch(AVector* self, size_t start, const void* value, const AKeyComp* comp)
+{
+	switch (comp->kind)
+	{
+		case AKeyPointer: return AVectorScan(self->values, start, self->size, value);
+		case AKeyInt32:   return AVectorMatchKind(self, start, value, comp, AKeyInt32);
+		case AKeyInt64:   return AVectorMatchKind(self, start, value, comp, AKeyInt64);
+		case AKeyString:  return AVectorMatchKind(self, start, value, comp, AKeyString);
+		case AKeyBytes:   return AVectorMatchKind(self, start, value, comp, AKeyBytes);
+		case AKeyAString: return AVectorMatchKind(self, start, value, comp, AKeyAString);
+		default:          return AVectorMatchKind(self, start, value, comp, AKeyCustom);
+	}
+}
+
+/*
+ * Descriptor of the comparison function, where no function matches the pointers themselves
+ */
+static AKeyComp AVectorDescribe(AValueComp comp)
+{
+	AKeyComp desc;
+
+	if (comp != NULL)
+	{
+		return AComp->describe(comp);
+	}
+
+	desc.kind = AKeyPointer;
+	desc.size = 0;
+	desc.comp = AComp->pointerComp;
+	return desc;
+}
+
+/**
+ * @fn size_t (*AVector::indexOf)(AVector* self, const void* value, AValueComp comp)
+ * @param self The vector
+ * @param value The value to search for
+ * @param comp Comparison function of the values, or NULL to search for the pointer value itself
+ * @return The first position of the value, or @ref AVECTOR_NPOS if it isn't in the vector
+ *
+ * Search the vector from its start for a value equal to value by the comparison function, which is
+ * passed a value of the vector as its first argument. Pointers (and integers stored in pointers)
+ * are searched for without a comparison function, several at a time using SIMD instructions.
+ */
+static size_t AVectorIndexOf(AVector* self, const void* value, AValueComp comp)
+{
+	AKeyComp desc = AVectorDescribe(comp);
+	size_t pos;
+
+	if (self == NULL || (pos = AVectorMatch(self, 0, value, &desc)) == self->size)
+	{
+		return AVECTOR_NPOS;
+	}
+
+	return pos;
+}
+
+/**
+ * @fn void** (*AVector::find)(AVector* self, const void* value, AValueComp comp)
+ * @param self The vector
+ * @param value The value to search for
+ * @param comp Comparison function of the values, or NULL to search for the pointer value itself
+ * @return Pointer to the first value equal to value in the vector, or NULL if there's none
+ *
+ * Search the vector like AVector::indexOf().
+ */
+static void** AVectorFind(AVector* self, const void* value, AValueComp comp)
+{
+	size_t pos = AVectorIndexOf(self, value, comp);
+
+	return pos != AVECTOR_NPOS ? &self->values[pos] : NULL;
+}
+
+/**
+ * @fn size_t (*AVector::count)(AVector* self, const void* value, AValueComp comp)
+ * @param self The vector
+ * @param value The value to count
+ * @param comp Comparison function of the values, or NULL to count the pointer value itself
+ * @return Number of values equal to value in the vector
+ *
+ * Search the whole vector like AVector::indexOf().
+ */
+static size_t AVectorCount(AVector* self, const void* value, AValueComp comp)
+{
+	AKeyComp desc = AVectorDescribe(comp);
+	size_t pos, count = 0;
+
+	if (self == NULL)
+	{
+		return 0;
+	}
+
+	for (pos = AVectorMatch(self, 0, value, &desc); pos < self->size; pos = AVectorMatch(self, pos + 1, value, &desc))
+	{
+		count++;
+	}
+
+	return count;
+}
+
+/**
+ * @fn int (*AVector::contains)(AVector* self, const void* value, AValueComp comp)
+ * @param self The vector
+ * @param value The value to search for
+ * @param comp Comparison function of the values, or NULL to search for the pointer value itself
+ * @return Non-zero if a value equal to value is in the vector, or zero otherwise
+ *
+ * Search the vector like AVector::indexOf().
+ */
+static int AVectorContains(AVector* self, const void* value, AValueComp comp)
+{
+	return AVectorIndexOf(self, value, comp) != AVECTOR_NPOS;
+}
+
+/*
+ * Mapping, filtering and reducing
+ *
+ * The values are split into chunks which are handed out to the threads (see AParallel), a few chunks per
+ * thread so threads which finish their chunks early take more of them. Filtering first marks the matching
+ * values and counts the matches of every chunk, then sums the counts of the chunks before each chunk into
+ * the position of its first match, and finally copies the matches of all the chunks to their positions at
+ * the same time. Small vectors are handled by the calling thread only.
+ */
+
+static const size_t EACH_PARALLEL_MIN = 1 << 12;  /* Vectors smaller than this are handled by one thread */
+static const size_t EACH_CHUNKS = 4;              /* Number of chunks per thread */
+
+/* A map, filter or reduce split across threads */
+typedef struct AVectorEachJob
+{
+	void** values;
+	void** target;           /* The values the results are stored to */
+	size_t size;
+	size_t chunks;
+	AValueFunc func;
+	AValuePredicate predicate;
+	AValueCombine combine;
+	unsigned char* matches;  /* Whether the predicate matched each value */
+	size_t* offsets;         /* Number of matches of each chunk, and then the position of its first one */
+	void** results;          /* The combined values of each chunk */
+} AVectorEachJob;
+
+/*
+ * Number of chunks to split a vector of some size into
+ */
+static size_t AVectorEachChunks(size_t size)
+{
+	size_t threads = AParallel->threads();
+
+	if (size < EACH_PARALLEL_MIN || threads < 2)
+	{
+		return 1;
+	}
+
+	return threads * EACH_CHUNKS < size ? threads * EACH_CHUNKS : size;
+}
+
+static void AVectorMapChunk(void* arg, size_t index)
+{
+	AVectorEachJob* job = arg;
+	size_t i, end = ASplit(job->size, index + 1, job->chunks);
+
+	for (i = ASplit(job->size, index, job->chunks); i < end; i++)
+	{
+		job->target[i] = job->func(job->values[i]);
+	}
+}
+
+static void AVectorFilterCount(void* arg, size_t index)
+{
+	AVectorEachJob* job = arg;
+	size_t i, count = 0, end = ASplit(job->size, index + 1, job->chunks);
+
+	for (i = ASplit(job->size, index, job->chunks); i < end; i++)
+	{
+		count += job->matches[i] = job->predicate(job->values[i]) != 0;
+	}
+
+	job->offsets[index] = count;
+}
+
+static void AVectorFilterMove(void* arg, size_t index)
+{
+	AVectorEachJob* job = arg;
+	void** target = job->target + job->offsets[index];
+	size_t i, end = ASplit(job->size, index + 1, job->chunks);
+
+	for (i = ASplit(job->size, index, job->chunks); i < end; i++)
+	{
+		if (job->matches[i])
+		{
+			*target++ = job->values[i];
+		}
+	}
+}
+
+static void AVectorReduceChunk(void* arg, size_t index)
+{
+	AVectorEachJob* job = arg;
+	size_t i = ASplit(job->size, index, job->chunks);
+	size_t end = ASplit(job->size, index + 1, job->chunks);
+	void* result = job->values[i];
+
+	while (++i < end)
+	{
+		result = job->combine(result, job->values[i]);
+	}
+
+	job->results[index] = result;
+}
+
+/**
+ * @fn AVector* (*AVector::map)(AVector* self, AValueFunc func)
+ * @param self The vector
+ * @param func Callback function returning the new value of a value
+ * @return The vector or NULL on error
+ *
+ * Replace every value of the vector by what func returns for it. Large vectors are split
+ * across the threads of ::AParallel, so func may be called for several values at the same
+ * time, in any order.
+ */
+static AVector* AVectorMap(AVector* self, AValueFunc func)
+{
+	AVectorEachJob job;
+
+	if (self == NULL || func == NULL)
+	{
+		return NULL;
+	}
+
+	job.values = job.target = self->values;
+	job.size = self->size;
+	job.chunks = AVectorEachChunks(self->size);
+	job.func = func;
+	AParallel->run(AVectorMapChunk, &job, job.chunks);
+
+	return self;
+}
+
+/**
+ * @fn AVector* (*AVector::transform)(AVector* self, AValueFunc func)
+ * @param self The vector
+ * @param func Callback function returning the value of the new vector for a value
+ * @return A new vector or NULL on error
+ *
+ * Create a new vector of what func returns for every value, in the same order. The vector
+ * itself isn't changed. Like AVector::map(), func may be called for several values at the same time.
+ */
+static AVector* AVectorTransform(AVector* self, AValueFunc func)
+{
+	AVectorEachJob job;
+	AVector* result;
+
+	if (self == NULL || func == NULL || (result = AStruct->ANew(AVector)) == NULL)
+	{
+		return NULL;
+	}
+
+	if (AVectorReserve(result, self->size) == NULL)
+	{
+		AVectorDestroy(result, NULL);
+		return NULL;
+	}
+
+	job.values = self->values;
+	job.target = result->values;
+	job.size = result->size = self->size;
+	job.chunks = AVectorEachChunks(self->size);
+	job.func = func;
+	AParallel->run(AVectorMapChunk, &job, job.chunks);
+
+	return result;
+}
+
+/**
+ * @fn AVector* (*AVector::filter)(AVector* self, AValuePredicate predicate)
+ * @param self The vector
+ * @param predicate Callback function returning non-zero for values to keep
+ * @return A new vector or NULL on error
+ *
+ * Create a new vector of the values the predicate matches, in the same order. The vector itself
+ * isn't changed (use AVector::removeIf() to remove values in place). The predicate is called once for
+ * every value, and like AVector::map(), it may be called for several values at the same time.
+ */
+static AVector* AVectorFilter(AVector* self, AValuePredicate predicate)
+{
+	AVectorEachJob job;
+	AVector* result;
+	size_t c, count, total = 0;
+
+	if (self == NULL || predicate == NULL || (result = AStruct->ANew(AVector)) == NULL)
+	{
+		return NULL;
+	}
+
+	if (self->size == 0)
+	{
+		return result;
+	}
+
+	job.values = self->values;
+	job.size = self->size;
+	job.chunks = AVectorEachChunks(self->size);
+	job.predicate = predicate;
+	job.matches = malloc(self->size);
+	job.offsets = malloc(job.chunks * sizeof *job.offsets);
+
+	if (job.matches == NULL || job.offsets == NULL)
+	{
+		free(job.matches);
+		free(job.offsets);
+		AVectorDestroy(result, NULL);
+		return NULL;
+	}
+
+	AParallel->run(AVectorFilterCount, &job, job.chunks);
+
+	for (c = 0; c < job.chunks; c++)
+	{
+		count = job.offsets[c];
+		job.offsets[c] = total;
+		total += count;
+	}
+
+	if (AVectorReserve(result, total) == NULL)
+	{
+		AVectorDestroy(result, NULL);
+		result = NULL;
+	}
+	else
+	{
+		job.target = result->values;
+		result->size = total;
+		AParallel->run(AVectorFilterMove, &job, job.chunks);
+	}
+
+	free(job.matches);
+	free(job.offsets);
+
+	return result;
+}
+
+/**
+ * @fn void* (*AVector::reduce)(AVector* self, AValueCombine combine, void* initial)
+ * @param self The vector
+ * @param combine Callback function combining two values into one
+ * @param initial The value the values are combined with
+ * @return The combined value, or initial if the vector is empty
+ *
+ * Combine initial and all the values of the vector, in order, into one value:
+ * combine(combine(combine(initial, v0), v1), v2) and so on. The combining function must be associative,
+ * as large vectors are split into chunks which are combined at the same time, each starting from its
+ * first value, and then the results of the chunks are combined in order. It doesn't need to be commutative.
+ *
+ * Example of summing a vector of sizes stored as the value pointers:
+ * @code
+ * void* sum(void* a, void* b)
+ * {
+ *     return (void *)((size_t)a + (size_t)b);
+ * }
+ *
+ * size_t total = (size_t)vector->reduce(vector, sum, (void *)0);
+ * @endcode
+ */
+static void* AVectorReduce(AVector* self, AValueCombine combine, void* initial)
+{
+	AVectorEachJob job;
+	size_t c;
+	void* result = initial;
+
+	if (self == NULL || combine == NULL)
+	{
+		return initial;
+	}
+
+	job.values = self->values;
+	job.size = self->size;
+	job.chunks = AVectorEachChunks(self->size);
+	job.combine = combine;
+
+	if (job.chunks > 1 && (job.results = malloc(job.chunks * sizeof *job.results)) != NULL)
+	{
+		AParallel->run(AVectorReduceChunk, &job, job.chunks);
+
+		for (c = 0; c < job.chunks; c++)
+		{
+			result = combine(result, job.results[c]);
+		}
+
+		free(job.results);
+		return result;
+	}
+
+	for (c = 0; c < self->size; c++)
+	{
+		result = combine(result, self->values[c]);
+	}
+
+	return result;
+}
+
+/**
+ * @fn AVector* (*AVector::view)(AVector* self, size_t pos, size_t size)
+ * @param self The vector
+ * @param pos Position index of the start of the view
+ * @param size The size of the view
+ * @return A new view or NULL on error
+ *
+ * Create a view of the positions of the vector starting from the position with the given size.
+ * A view is a vector which borrows the values of the vector instead of copying them, so creating
+ * it takes O(1) time whatever its size. Every function which doesn't change the size of a vector
+ * accepts a view, such as AVector::get(), AVector::find(), AVector::isSorted(), or AVector::copy();
+ * functions which set or sort values change the values of the vector itself. Adding or removing
+ * values of a view fails, so do it through the vector.
+ *
+ * The view is valid until the vector changes its size or is destroyed. Destroy the view using
+ * AVector::destroy(), which ignores freeValue for views, as the values belong to the vector.
+ *
+ * Example of a page of a large vector:
+ * @code
+ * AVector* page = vector->view(vector, pageNumber * pageSize, pageSize);
+ * @endcode
+ */
+static AVector* AVectorView(AVector* self, size_t pos, size_t size)
+{
+	AVector* view;
+
+	if (self == NULL || pos > self->size || size > self->size - pos || (view = AStruct->ANew(AVector)) == NULL)
+	{
+		return NULL;
+	}
+
+	view->values = self->values + pos;
+	view->size = view->capacity = size;
+	view->storage.outside.mapped = 0;
+	view->storage.outside.owner = AVectorOwner(self) != NULL ? AVectorOwner(self) : self;
+
+	return view;
+}
+
+/**
+ * @fn int (*AVector::isSorted)(AVector* self, AValueComp comp)
+ * @param self The vector
+ * @param comp Comparison function of the values
+ * @return Non-zero if no value is less than the value before it, or zero otherwise
+ *
+ * Check whether the vector is sorted in O(n) time, stopping at the first value out of order.
+ */
+static int AVectorIsSorted(AVector* self, AValueComp comp)
+{
+	size_t i;
+
+	if (self == NULL || comp == NULL)
+	{
+		return 0;
+	}
+
+	for (i = 1; i < self->size; i++)
+	{
+		if (comp(self->values[i], self->values[i - 1]) < 0)
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
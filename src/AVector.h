@@ -7,9 +7,53 @@
 
 #include <stdarg.h>
 #include "AStructBase.h"
+#include "AComp.h"
 
 typedef struct AVector AVector;
 
+/**
+ * Number of values a @link AVector vector@endlink stores inside itself. Vectors
+ * which never hold more values than that don't allocate separate storage for them.
+ */
+#define AVECTOR_LOCAL_CAPACITY 8
+
+/**
+ * Position returned by AVector::indexOf() when the value isn't in the @link AVector vector@endlink
+ */
+#define AVECTOR_NPOS ((size_t)-1)
+
+/**
+ * @link AVector Vector@endlink growth policy
+ *
+ * Decides how the capacity of a vector changes as values are added and removed, and
+ * where very large vectors keep their values. New vectors double their capacity when
+ * they're full, never shrink and always allocate their storage with malloc().
+ *
+ * Example of a vector which grows by half when it's full, by a million items at a time once
+ * it holds a million items, and shrinks when it's less than a quarter full:
+ * @code
+ * AVectorGrowth growth = { 1.5, 1000000, 0.25 };
+ * vector->growth = growth;
+ * @endcode
+ *
+ * Example of a vector for an index of billions of items, which maps its storage
+ * once it holds 16M items (128MB) and uses huge pages for faster random access:
+ * @code
+ * vector->growth.mapAbove = 1 << 24;
+ * vector->growth.hugePages = 1;
+ * @endcode
+ */
+typedef struct AVectorGrowth
+{
+	double factor;      /**< The capacity is multiplied by factor (greater than 1) when the vector is full */
+	size_t chunk;       /**< If not 0, the capacity grows by chunk items at a time once it's at least chunk items */
+	double shrinkBelow; /**< If not 0, the vector shrinks when its size falls below this ratio of its capacity.
+	                         Keep it below 1 / factor so the vector doesn't shrink and grow back repeatedly. */
+	size_t mapAbove;    /**< If not 0, storage for at least mapAbove items is mapped from the system (where
+	                         supported), and grows by remapping its pages instead of copying the values */
+	int hugePages;      /**< Whether to ask the system to back mapped storage with transparent huge pages */
+} AVectorGrowth;
+
 /**
  * Dynamic array
  *
@@ -17,9 +61,15 @@ typedef struct AVector AVector;
  * you need an array of unknown size which expands on its own. Dynamic arrays have fast insertations
  * and removals from the end, and random access is constant.
  *
+ * Small vectors keep their values inside the vector itself, and move them to separately allocated
+ * storage only when they grow past @ref AVECTOR_LOCAL_CAPACITY values. So a pointer to a value in
+ * the vector, like the ones AVector::append() returns, is valid only until the vector is changed.
+ * AVector::view() gets a range of positions as a vector of its own, without copying the values.
+ *
  * The arguments passed to @link ANew AStruct->ANew()@endlink to create a new vector are:
  * @code AStruct->ANew(AVector, int capacity)@endcode
  * @param [opt]capacity = Optional argument to specify the initial capacity of the vector
+ * (a new vector can hold at least @ref AVECTOR_LOCAL_CAPACITY values without expanding)
  *
  * Examples of creating a new vector:
  * @code
@@ -45,10 +95,57 @@ struct AVector
 	                             AValueFunc copyValue);
 	AVector*  (*const copy)(AVector* self, AValueFunc copyValue);         /**< Copy the entire vector */
 	AVector*  (*const join)(AVector* first, AVector* second);             /**< Join two vectors */
+	void**    (*const insertRange)(AVector* self, size_t pos,
+	                               void* const* values, size_t count);    /**< Insert an array of values at the position */
+	size_t    (*const eraseRange)(AVector* self, size_t pos, size_t count,
+	                              AValueFree freeValue);                  /**< Erase a range of positions from the vector */
+	size_t    (*const removeIf)(AVector* self, AValuePredicate predicate,
+	                            AValueFree freeValue);                    /**< Remove all the values matching a predicate */
+	void**    (*const appendArray)(AVector* self, void* const* values,
+	                               size_t count);                         /**< Append an array of values */
+	void**    (*const appendN)(AVector* self, void* value, size_t count); /**< Append a value several times */
+	AVector*  (*const extend)(AVector* self, AVector* other);             /**< Append all the values of another vector */
+	AVector*  (*const reserve)(AVector* self, size_t capacity);           /**< Reserve capacity for a number of items */
+	AVector*  (*const shrinkToFit)(AVector* self);                        /**< Shrink the capacity to the size */
+	AVector*  (*const sort)(AVector* self, AValueComp comp);              /**< Sort the values */
+	AVector*  (*const stableSort)(AVector* self, AValueComp comp);        /**< Sort the values keeping equal values in order */
+	AVector*  (*const radixSort)(AVector* self, AValueKey key,
+	                             size_t keyBytes);                        /**< Sort the values by integer keys */
+	size_t    (*const lowerBound)(AVector* self, const void* value,
+	                              AValueComp comp);                       /**< Find the first position not less than a value */
+	size_t    (*const upperBound)(AVector* self, const void* value,
+	                              AValueComp comp);                       /**< Find the first position greater than a value */
+	void**    (*const binarySearch)(AVector* self, const void* value,
+	                                AValueComp comp);                     /**< Find a value in a sorted vector */
+	void**    (*const find)(AVector* self, const void* value,
+	                        AValueComp comp);                             /**< Find the first position of a value */
+	size_t    (*const indexOf)(AVector* self, const void* value,
+	                           AValueComp comp);                          /**< Get the first position of a value */
+	size_t    (*const count)(AVector* self, const void* value,
+	                         AValueComp comp);                            /**< Count the positions of a value */
+	int       (*const contains)(AVector* self, const void* value,
+	                            AValueComp comp);                         /**< Check whether the vector has a value */
+	AVector*  (*const map)(AVector* self, AValueFunc func);               /**< Replace every value by a function of it */
+	AVector*  (*const transform)(AVector* self, AValueFunc func);         /**< Get a new vector of a function of every value */
+	AVector*  (*const filter)(AVector* self, AValuePredicate predicate);  /**< Get a new vector of the values matching a predicate */
+	void*     (*const reduce)(AVector* self, AValueCombine combine,
+	                          void* initial);                             /**< Combine all the values into one */
+	AVector*  (*const view)(AVector* self, size_t pos, size_t size);      /**< Get a view of a range of positions without copying */
+	int       (*const isSorted)(AVector* self, AValueComp comp);          /**< Check whether the values are sorted */
 
-	void** values;   /*<  Dynamic array of pointers to values */
-	size_t size;     /**< Number of items in the vector */
-	size_t capacity; /*<  The allocated size of the array of values */
+	void** values;        /*<  Dynamic array of pointers to values */
+	size_t size;          /**< Number of items in the vector */
+	size_t capacity;      /*<  The allocated size of the array of values */
+	AVectorGrowth growth; /**< The growth policy of the vector */
+	union
+	{
+		void* local[AVECTOR_LOCAL_CAPACITY]; /*<  Storage for the values while they fit inside the vector */
+		struct
+		{
+			size_t mapped;                   /*<  Size in bytes of the mapped storage of the values (0 if it isn't mapped) */
+			AVector* owner;                  /*<  The vector a view borrows its values from (NULL if the vector owns them) */
+		} outside;                           /*<  State of values stored outside the vector (valid only while they are) */
+	} storage;            /*<  The local storage and the state of outside storage share the same space */
 };
 
 extern const AVector AVectorProto;
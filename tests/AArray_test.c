@@ -0,0 +1,110 @@
+#include "minunit.h"
+#include <stdlib.h>
+#include "AArray.h"
+
+typedef struct Record
+{
+	int id;
+	double weight;
+	char name[4];
+} Record;
+
+static AArray* array = NULL;
+Record testData[] = { { 1, 1.5, "foo" }, { 2, 2.5, "bar" }, { 3, 3.5, "baz" }, { 4, 4.5, "bug" } };
+
+const char* testCreate(void)
+{
+	massert(AStruct->ANew(AArray) == NULL, "Created array without element size");
+
+	array = AStruct->ANew(AArray, sizeof(Record), 2);
+	massert(array != NULL, "Failed to create a new array");
+	massert(array->capacity == 2, "Wrong capacity after creation");
+	massert(array->elementSize == sizeof(Record), "Wrong element size after creation");
+
+	return NULL;
+}
+
+const char* testDestroy(void)
+{
+	massert(array != NULL, "Invalid array");
+	array->destroy(array);
+
+	return NULL;
+}
+
+const char* testAppend(void)
+{
+	size_t i;
+
+	for (i = 0; i < ARR_SIZE(testData); i++)
+	{
+		Record* record = array->append(array, &testData[i]);
+		massert(record != NULL, "Failed to append");
+		massert(record == array->get(array, i), "Append returned a wrong pointer");
+		massert(!memcmp(record, &testData[i], sizeof *record), "Wrong element on append");
+	}
+
+	massert(array->size == ARR_SIZE(testData), "Wrong size after append");
+	massert((Record *)array->elements + 1 == array->get(array, 1), "Elements aren't contiguous");
+
+	return NULL;
+}
+
+const char* testInsertRemove(void)
+{
+	Record removed;
+	Record* record = array->insert(array, 1, NULL);
+
+	massert(record != NULL && record->id == 0, "Failed to insert a zeroed element");
+	massert(array->size == ARR_SIZE(testData) + 1, "Wrong size after insert");
+	massert(((Record *)array->get(array, 2))->id == testData[1].id, "Elements weren't moved on insert");
+
+	massert(array->remove(array, 1, &removed) == array && removed.id == 0, "Failed to remove");
+	massert(array->remove(array, array->size, NULL) == NULL, "Removed invalid position");
+	massert(array->insert(array, 0, NULL) != NULL && array->remove(array, 0, NULL) == array,
+			"Failed to remove without copying the element");
+	massert(array->size == ARR_SIZE(testData), "Wrong size after remove");
+	massert(((Record *)array->get(array, 1))->id == testData[1].id, "Elements weren't moved on remove");
+
+	return NULL;
+}
+
+const char* testSet(void)
+{
+	Record* record = array->set(array, 0, &testData[3]);
+
+	massert(record != NULL && record->id == testData[3].id, "Failed to set");
+	record = array->set(array, 0, &testData[0]);
+	massert(record != NULL && record->id == testData[0].id, "Failed to set");
+	massert(array->set(array, array->size + 1, &testData[0]) == NULL, "Set invalid position");
+
+	return NULL;
+}
+
+const char* testSubArrayCopyJoin(void)
+{
+	size_t i;
+	AArray* sub = array->subArray(array, 1, 2);
+	AArray* copy = array->copy(array);
+
+	massert(sub != NULL && sub->size == 2, "Failed to create sub array");
+	massert(!memcmp(sub->elements, array->get(array, 1), 2 * sizeof(Record)), "Wrong elements in sub array");
+	massert(copy != NULL && copy->size == array->size, "Failed to copy");
+
+	massert(array->join(array, copy) == array, "Failed to join");
+	massert(array->size == 2 * ARR_SIZE(testData), "Wrong size after join");
+
+	for (i = 0; i < array->size; i++)
+	{
+		massert(!memcmp(array->get(array, i), &testData[i % ARR_SIZE(testData)], sizeof(Record)),
+				"Wrong element after join");
+	}
+
+	massert(array->reserve(array, 100) == array && array->capacity == 100, "Failed to reserve");
+	massert(array->shrinkToFit(array) == array && array->capacity == array->size, "Failed to shrink to fit");
+	sub->destroy(sub);
+
+	return NULL;
+}
+
+mrun(testCreate, testAppend, testInsertRemove, testSet, testSubArrayCopyJoin, testDestroy);
@@ -0,0 +1,125 @@
+#include "minunit.h"
+#include "ABitset.h"
+
+#define NUM_BITS 1000
+
+static ABitset* bits = NULL;
+
+const char* testCreate(void)
+{
+	ABitset* sized = AStruct->ANew(ABitset, 100);
+
+	massert(sized != NULL && sized->size == 100 && sized->count(sized) == 0, "Failed to create sized bitset");
+	sized->destroy(sized);
+
+	bits = AStruct->ANew(ABitset);
+	massert(bits != NULL && bits->size == 0, "Failed to create bitset");
+
+	return NULL;
+}
+
+const char* testDestroy(void)
+{
+	massert(bits != NULL, "Invalid bitset");
+	bits->destroy(bits);
+
+	return NULL;
+}
+
+const char* testSetTest(void)
+{
+	size_t i;
+
+	/* Multiples of 3 */
+	for (i = 0; i < NUM_BITS; i += 3)
+	{
+		massert(bits->set(bits, i) == bits, "Failed to set bit");
+	}
+
+	massert(bits->size == NUM_BITS - 1 + 1, "Wrong size after set");
+
+	for (i = 0; i < NUM_BITS + 100; i++)
+	{
+		massert(!bits->test(bits, i) == !(i % 3 == 0 && i < NUM_BITS), "Wrong bit");
+	}
+
+	bits->reset(bits, 3);
+	bits->reset(bits, NUM_BITS * 2);
+	massert(!bits->test(bits, 3) && bits->size == NUM_BITS, "Failed to reset bit");
+	bits->set(bits, 3);
+
+	return NULL;
+}
+
+const char* testCount(void)
+{
+	size_t i, n;
+
+	massert(bits->count(bits) == (NUM_BITS + 2) / 3, "Wrong count");
+	massert(bits->rank(bits, 0) == 0 && bits->rank(bits, 4) == 2 && bits->rank(bits, 130) == 44, "Wrong rank");
+	massert(bits->rank(bits, NUM_BITS * 2) == bits->count(bits), "Wrong rank past the end");
+
+	for (n = 0, i = bits->findNext(bits, 0); i != ABITSET_NPOS; i = bits->findNext(bits, i + 1), n++)
+	{
+		massert(i == 3 * n, "Wrong next bit");
+		massert(bits->select(bits, n) == i && bits->rank(bits, i) == n, "Wrong select");
+	}
+
+	massert(n == bits->count(bits), "Wrong number of next bits");
+	massert(bits->select(bits, n) == ABITSET_NPOS, "Selected missing bit");
+	massert(bits->findNext(bits, NUM_BITS * 2) == ABITSET_NPOS, "Found bit past the end");
+
+	return NULL;
+}
+
+const char* testCombine(void)
+{
+	ABitset* evens = AStruct->ANew(ABitset);
+	ABitset* result;
+	size_t i;
+
+	/* Even bits up to twice the size */
+	for (i = 0; i < 2 * NUM_BITS; i += 2)
+	{
+		evens->set(evens, i);
+	}
+
+	result = bits->copy(bits);
+	massert(result->andWith(result, evens) == result && result->size == NUM_BITS, "Failed to intersect");
+	for (i = 0; i < NUM_BITS; i++)
+	{
+		massert(!result->test(result, i) == !(i % 6 == 0), "Wrong bit after intersecting");
+	}
+	result->destroy(result);
+
+	result = bits->copy(bits);
+	massert(result->orWith(result, evens) == result && result->size == evens->size, "Failed to unite");
+	for (i = 0; i < 2 * NUM_BITS; i++)
+	{
+		massert(!result->test(result, i) == !((i % 3 == 0 && i < NUM_BITS) || i % 2 == 0), "Wrong bit after uniting");
+	}
+	result->destroy(result);
+
+	result = bits->copy(bits);
+	massert(result->xorWith(result, evens) == result, "Failed to xor");
+	for (i = 0; i < 2 * NUM_BITS; i++)
+	{
+		massert(!result->test(result, i) == !((i % 3 == 0 && i < NUM_BITS) != (i % 2 == 0)), "Wrong bit after xor");
+	}
+	result->destroy(result);
+
+	result = evens->copy(evens);
+	massert(result->andNotWith(result, bits) == result, "Failed to subtract");
+	massert(result->count(result) == NUM_BITS - (NUM_BITS / 6 + 1), "Wrong count after subtracting");
+	result->resize(result, 7);
+	massert(result->count(result) == 2 && result->resize(result, 100)->count(result) == 2, "Resizing kept removed bits");
+	result->destroy(result);
+
+	evens->clear(evens);
+	massert(evens->size == 0 && evens->count(evens) == 0, "Failed to clear");
+	evens->destroy(evens);
+
+	return NULL;
+}
+
+mrun(testCreate, testSetTest, testCount, testCombine, testDestroy);
@@ -0,0 +1,123 @@
+#include "minunit.h"
+#include "AColumnar.h"
+#include "AParallel.h"
+
+#define NUM_ROWS 10000
+
+/* A packed row: no padding between the fields */
+typedef struct Row
+{
+	double price;
+	int quantity;
+	int venue;
+} Row;
+
+static const size_t sizes[] = { sizeof(double), sizeof(int), sizeof(int) };
+static AColumnar* table = NULL;
+
+const char* testCreate(void)
+{
+	size_t invalid[] = { 4, 0 };
+
+	massert(AStruct->ANew(AColumnar) == NULL, "Created table without columns");
+	massert(AStruct->ANew(AColumnar, 2, invalid) == NULL, "Created table with an empty column");
+	table = AStruct->ANew(AColumnar, (int)ARR_SIZE(sizes), sizes);
+	massert(table != NULL && table->numColumns == 3 && table->rowSize == sizeof(Row), "Failed to create table");
+
+	return NULL;
+}
+
+const char* testDestroy(void)
+{
+	massert(table != NULL, "Invalid table");
+	table->destroy(table);
+
+	return NULL;
+}
+
+const char* testRows(void)
+{
+	Row row;
+	size_t i;
+
+	for (i = 0; i < NUM_ROWS; i++)
+	{
+		row.price = i / 2.0;
+		row.quantity = (int)i;
+		row.venue = (int)i % 7;
+		massert(table->append(table, &row) == table, "Failed to append row");
+	}
+
+	massert(table->size == NUM_ROWS, "Wrong size after append");
+	massert(table->get(table, 10, &row) == &row && row.price == 5.0 && row.quantity == 10 && row.venue == 3,
+	        "Wrong row");
+	massert(table->get(table, NUM_ROWS, &row) == NULL, "Got row past the end");
+
+	row.quantity = -1;
+	massert(table->set(table, 20, &row) == table, "Failed to set row");
+	massert(*(int *)table->at(table, 20, 1) == -1 && *(double *)table->at(table, 20, 0) == 5.0, "Wrong field after set");
+	massert(table->set(table, 30, NULL) == table && *(int *)table->at(table, 30, 2) == 0, "Failed to zero row");
+	massert(table->at(table, 0, 3) == NULL && table->column(table, 3) == NULL, "Got field of missing column");
+
+	/* Columns are contiguous arrays */
+	massert(((int *)table->column(table, 1))[40] == 40 && ((double *)table->column(table, 0))[41] == 20.5,
+	        "Wrong values of column");
+	massert(table->reserve(table, 2 * NUM_ROWS) == table && table->size == NUM_ROWS, "Failed to reserve");
+
+	return NULL;
+}
+
+static void sumChunk(void* arg, size_t chunk, const void* values, size_t first, size_t count)
+{
+	long* sums = arg;
+	const int* quantities = values;
+	size_t i;
+
+	(void)first;
+	for (i = 0; i < count; i++)
+	{
+		sums[chunk] += quantities[i];
+	}
+}
+
+const char* testScan(void)
+{
+	long sums[8];
+	long total, expected = 0;
+	size_t chunks[] = { 1, 3, 8 };
+	size_t i, c;
+
+	for (i = 0; i < NUM_ROWS; i++)
+	{
+		expected += *(int *)table->at(table, i, 1);
+	}
+
+	AParallel->setThreads(3);
+
+	for (c = 0; c < ARR_SIZE(chunks); c++)
+	{
+		for (i = 0; i < ARR_SIZE(sums); i++)
+		{
+			sums[i] = 0;
+		}
+
+		massert(table->scan(table, 1, chunks[c], sumChunk, sums) == table, "Failed to scan");
+
+		for (i = 0, total = 0; i < chunks[c]; i++)
+		{
+			total += sums[i];
+		}
+
+		massert(total == expected, "Wrong sum of scan");
+	}
+
+	AParallel->setThreads(0);
+	massert(table->scan(table, 1, 0, sumChunk, sums) == NULL, "Scanned without chunks");
+
+	table->clear(table);
+	massert(table->size == 0 && table->get(table, 0, sums) == NULL, "Failed to clear");
+
+	return NULL;
+}
+
+mrun(testCreate, testRows, testScan, testDestroy);
@@ -0,0 +1,111 @@
+#include "minunit.h"
+#include <stdlib.h>
+#include "AComp.h"
+
+static int sign(int n)
+{
+	return (n > 0) - (n < 0);
+}
+
+static int bytesComp(const void* a, const void* b)
+{
+	return memcmp(a, b, sizeof(int));
+}
+
+const char* testBuiltins(void)
+{
+	int a = -2000000000, b = 2000000000;
+	long long c = -(long long)(1ULL << 62), d = (long long)(1ULL << 62);
+
+	massert(AComp->intComp(&a, &b) < 0 && AComp->intComp(&b, &a) > 0, "Wrong int order");
+	massert(AComp->intComp(&a, &a) == 0, "Equal ints differ");
+	massert(AComp->int64Comp(&c, &d) < 0 && AComp->int64Comp(&d, &c) > 0, "Wrong long long order");
+	massert(AComp->pointerComp(&a, &a) == 0, "Equal pointers differ");
+
+	return NULL;
+}
+
+const char* testDescribe(void)
+{
+	massert(AComp->describe(AComp->intComp).kind == AKeyInt32, "Wrong kind of intComp");
+	massert(AComp->describe(AComp->int64Comp).kind == AKeyInt64, "Wrong kind of int64Comp");
+	massert(AComp->describe(AComp->pointerComp).kind == AKeyPointer, "Wrong kind of pointerComp");
+	massert(AComp->describe(AComp->stringComp).kind == AKeyString, "Wrong kind of stringComp");
+	massert(AComp->describe(AComp->astringComp).kind == AKeyAString, "Wrong kind of astringComp");
+	massert(AComp->describe(bytesComp).kind == AKeyCustom, "Wrong kind of a custom function");
+
+	return NULL;
+}
+
+const char* testAStringComp(void)
+{
+	const size_t PAGE = 4096;
+	char* buffer = malloc(3 * PAGE);
+	char* page = buffer + PAGE - (size_t)buffer % PAGE; /* start of a page inside the buffer */
+	char other[100];
+	size_t start, size, diff;
+
+	massert(buffer != NULL, "Failed to allocate buffer");
+	memset(buffer, 'x', 3 * PAGE);
+	memset(other, 'x', sizeof other);
+
+	/* Strings of any length and alignment, ending before, at and after a page boundary */
+	for (start = PAGE - 80; start < PAGE + 8; start += 3)
+	{
+		for (size = 0; size < 70; size++)
+		{
+			AString a = { page + start, size };
+			AString b = { other, size };
+			AString shorter = { other, size - (size > 0) };
+
+			massert(AComp->astringComp(&a, &b) == 0, "Equal strings differ");
+			massert(size == 0 || AComp->astringComp(&a, &shorter) > 0, "Prefix isn't less");
+			massert(size == 0 || AComp->astringComp(&shorter, &a) < 0, "Prefix isn't less");
+
+			for (diff = 0; diff < size; diff++)
+			{
+				other[diff] = 'y';
+				massert(sign(AComp->astringComp(&a, &b)) == sign(memcmp(a.data, b.data, size)), "Wrong order");
+				massert(sign(AComp->astringComp(&b, &a)) == sign(memcmp(b.data, a.data, size)), "Wrong order");
+				other[diff] = 'x';
+			}
+		}
+	}
+
+	free(buffer);
+
+	return NULL;
+}
+
+const char* testAStringExactSize(void)
+{
+	size_t size, diff;
+
+	/* Strings in buffers barely larger than them, so reading past the end is caught by sanitizers */
+	for (size = 0; size < 70; size++)
+	{
+		char* x = malloc(size + 1);
+		char* y = malloc(size + 1);
+		AString a = { x, size };
+		AString b = { y, size };
+
+		massert(x != NULL && y != NULL, "Failed to allocate strings");
+		memset(x, 'x', size);
+		memset(y, 'x', size);
+		massert(AComp->astringComp(&a, &b) == 0, "Equal strings differ");
+
+		for (diff = 0; diff < size; diff++)
+		{
+			y[diff] = 'y';
+			massert(AComp->astringComp(&a, &b) < 0 && AComp->astringComp(&b, &a) > 0, "Wrong order");
+			y[diff] = 'x';
+		}
+
+		free(x);
+		free(y);
+	}
+
+	return NULL;
+}
+
+mrun(testBuiltins, testDescribe, testAStringComp, testAStringExactSize);
@@ -0,0 +1,170 @@
+#include "minunit.h"
+#include "ACowVector.h"
+#include "AParallel.h"
+
+#define NUM_VALUES 1000
+
+static ACowVector* vector = NULL;
+
+const char* testCreate(void)
+{
+	vector = AStruct->ANew(ACowVector);
+	massert(vector != NULL && vector->size == 0 && !vector->immutable, "Failed to create vector");
+
+	return NULL;
+}
+
+const char* testDestroy(void)
+{
+	massert(vector != NULL, "Invalid vector");
+	vector->destroy(vector);
+
+	return NULL;
+}
+
+const char* testAppendGet(void)
+{
+	size_t i;
+
+	for (i = 0; i < NUM_VALUES; i++)
+	{
+		massert(vector->append(vector, (void *)i) == vector, "Failed to append");
+	}
+
+	for (i = 0; i < NUM_VALUES; i++)
+	{
+		massert(vector->get(vector, i) == (void *)i, "Wrong value");
+	}
+
+	massert(vector->get(vector, NUM_VALUES) == NULL, "Got value past the end");
+	massert(vector->set(vector, 5, (void *)50) == vector && vector->get(vector, 5) == (void *)50, "Failed to set");
+	vector->set(vector, 5, (void *)5);
+
+	return NULL;
+}
+
+static void readSnapshot(void* arg, size_t index)
+{
+	ACowVector* snapshot = arg;
+	size_t i;
+
+	for (i = 0; i < snapshot->size; i++)
+	{
+		if (snapshot->get(snapshot, i) != (void *)i)
+		{
+			snapshot->immutable = 0; /* Marks a wrong value for the test */
+		}
+	}
+
+	(void)index;
+}
+
+const char* testSnapshot(void)
+{
+	ACowVector* first = vector->snapshot(vector);
+	ACowVector* second;
+	ACowVector* nested;
+	size_t i;
+
+	massert(first != NULL && first->immutable && first->size == NUM_VALUES, "Failed to take snapshot");
+	massert(first->append(first, NULL) == NULL && first->set(first, 0, NULL) == NULL &&
+	        first->removeLast(first) == NULL, "Changed snapshot");
+
+	/* Change one value, append and remove some */
+	massert(vector->set(vector, 100, (void *)42) == vector, "Failed to set after snapshot");
+	massert(vector->removeLast(vector) == (void *)(NUM_VALUES - 1), "Failed to remove last value");
+	massert(vector->append(vector, (void *)7) == vector && vector->append(vector, (void *)8) == vector,
+	        "Failed to append after snapshot");
+
+	second = vector->snapshot(vector);
+	nested = second->snapshot(second);
+	vector->clear(vector);
+	massert(vector->size == 0 && vector->get(vector, 0) == NULL, "Failed to clear");
+
+	for (i = 0; i < NUM_VALUES; i++)
+	{
+		massert(first->get(first, i) == (void *)i, "Snapshot changed");
+		massert(second->get(second, i) == (i == 100 ? (void *)42 : i == NUM_VALUES - 1 ? (void *)7 : (void *)i),
+		        "Wrong value of second snapshot");
+	}
+
+	massert(second->size == NUM_VALUES + 1 && nested->get(nested, NUM_VALUES) == (void *)8, "Wrong second snapshot");
+
+	/* Readers on other threads */
+	AParallel->setThreads(4);
+	AParallel->run(readSnapshot, first, 8);
+	AParallel->setThreads(0);
+	massert(first->immutable, "Reader got wrong value");
+
+	first->destroy(first);
+	second->destroy(second);
+	massert(nested->get(nested, 100) == (void *)42, "Snapshot lost values of destroyed snapshot");
+	nested->destroy(nested);
+
+	massert(vector->append(vector, (void *)1) == vector && vector->get(vector, 0) == (void *)1, "Failed to append after clear");
+
+	return NULL;
+}
+
+const char* testSharing(void)
+{
+	const size_t SEGMENT_VALUES = ACOWVECTOR_SEGMENT * ACOWVECTOR_CHUNK;
+	const size_t pos = SEGMENT_VALUES + 5 * ACOWVECTOR_CHUNK + 1; /* In the 6th chunk of the 2nd segment */
+	ACowVector* shared = AStruct->ANew(ACowVector);
+	ACowVector* snapshot;
+	ACowDirectory* directory;
+	ACowDirectory* published;
+	ACowChunk* copied;
+	size_t i, j;
+
+	for (i = 0; i < 3 * SEGMENT_VALUES + 10; i++)
+	{
+		massert(shared->append(shared, (void *)i) == shared, "Failed to append");
+	}
+
+	snapshot = shared->snapshot(shared);
+	massert(shared->set(shared, pos, NULL) == shared, "Failed to set after snapshot");
+	directory = shared->directory;
+	published = snapshot->directory;
+
+	/* One write copies the directory, one segment and one chunk, and shares the rest */
+	massert(directory != published && directory->numSegments == 4 && published->numSegments == 4, "Directory wasn't copied");
+
+	for (i = 0; i < directory->numSegments; i++)
+	{
+		massert((directory->segments[i] == published->segments[i]) == (i != 1), "Wrong segments shared");
+		massert(directory->segments[i]->numChunks == published->segments[i]->numChunks, "Wrong number of chunks");
+
+		for (j = 0; j < directory->segments[i]->numChunks; j++)
+		{
+			massert((directory->segments[i]->chunks[j] == published->segments[i]->chunks[j]) == (i != 1 || j != 5),
+			        "Wrong chunks shared");
+		}
+	}
+
+	massert(snapshot->get(snapshot, pos) == (void *)pos && shared->get(shared, pos) == NULL, "Wrong value after write");
+
+	/* Writing the same chunk again doesn't copy anything */
+	copied = directory->segments[1]->chunks[5];
+	massert(shared->set(shared, pos + 1, NULL) == shared && shared->directory == directory &&
+	        directory->segments[1]->chunks[5] == copied, "Copied the vector's own chunk again");
+
+	/* Appending a new chunk copies the last segment only */
+	for (i = shared->size; i % ACOWVECTOR_CHUNK != 0; i++)
+	{
+		shared->append(shared, (void *)i);
+	}
+
+	massert(shared->append(shared, (void *)i) == shared && directory->segments[3] != published->segments[3] &&
+	        directory->segments[3]->numChunks == published->segments[3]->numChunks + 1 &&
+	        directory->segments[0] == published->segments[0], "Wrong segments after append");
+	massert(snapshot->size == 3 * SEGMENT_VALUES + 10 &&
+	        snapshot->get(snapshot, snapshot->size - 1) == (void *)(snapshot->size - 1), "Snapshot changed by append");
+
+	snapshot->destroy(snapshot);
+	shared->destroy(shared);
+
+	return NULL;
+}
+
+mrun(testCreate, testAppendGet, testSnapshot, testSharing, testDestroy);
@@ -0,0 +1,95 @@
+#include "minunit.h"
+#include <stdio.h> /* for remove() */
+#include "AFileVector.h"
+
+#define PATH "AFileVector_test.dat"
+#define NUM_ELEMENTS 1000
+
+typedef struct Point
+{
+	double x, y;
+} Point;
+
+static AFileVector* points = NULL;
+
+const char* testCreate(void)
+{
+	remove(PATH);
+	massert(AStruct->ANew(AFileVector, PATH, AFILEVECTOR_READ) == NULL, "Opened missing file");
+	massert(AStruct->ANew(AFileVector, PATH, AFILEVECTOR_CREATE) == NULL, "Created file without element size");
+	points = AStruct->ANew(AFileVector, PATH, AFILEVECTOR_CREATE, (int)sizeof(Point));
+	massert(points != NULL && points->size == 0 && points->elementSize == sizeof(Point), "Failed to create file vector");
+
+	return NULL;
+}
+
+const char* testAppend(void)
+{
+	Point p;
+	size_t i;
+
+	for (i = 0; i < NUM_ELEMENTS; i++)
+	{
+		p.x = (double)i;
+		p.y = -(double)i;
+		massert(points->append(points, &p) != NULL, "Failed to append");
+	}
+
+	p.x = 42;
+	p.y = -10;
+	massert(points->set(points, 10, &p) != NULL && ((Point *)points->get(points, 10))->x == 42, "Failed to set");
+	massert(points->get(points, NUM_ELEMENTS) == NULL, "Got element past the end");
+	massert(points->sync(points) == points, "Failed to sync");
+	points->destroy(points);
+
+	return NULL;
+}
+
+const char* testReopen(void)
+{
+	Point p = { 1, 2 };
+	size_t i;
+
+	massert(AStruct->ANew(AFileVector, PATH, AFILEVECTOR_READ, (int)sizeof(Point) + 1) == NULL,
+	        "Opened file of another element size");
+
+	points = AStruct->ANew(AFileVector, PATH, AFILEVECTOR_READ);
+	massert(points != NULL && points->size == NUM_ELEMENTS && points->elementSize == sizeof(Point), "Failed to open file");
+
+	for (i = 0; i < NUM_ELEMENTS; i++)
+	{
+		Point* q = points->get(points, i);
+		massert(q->x == (i == 10 ? 42 : (double)i) && q->y == -(double)i, "Wrong element after reopening");
+	}
+
+	massert(points->append(points, &p) == NULL && points->set(points, 0, &p) == NULL, "Changed read-only file");
+	points->destroy(points);
+
+	/* Append to the existing file */
+	points = AStruct->ANew(AFileVector, PATH, AFILEVECTOR_WRITE, (int)sizeof(Point));
+	massert(points != NULL && points->size == NUM_ELEMENTS, "Failed to open file for writing");
+	massert(points->append(points, &p) != NULL && points->size == NUM_ELEMENTS + 1, "Failed to append to existing file");
+	points->destroy(points);
+
+	points = AStruct->ANew(AFileVector, PATH, AFILEVECTOR_WRITE);
+	massert(points->size == NUM_ELEMENTS + 1 && ((Point *)points->get(points, NUM_ELEMENTS))->y == 2, "Appended element wasn't kept");
+	points->clear(points);
+	massert(points->size == 0 && points->reserve(points, 100) == points, "Failed to clear");
+
+	return NULL;
+}
+
+const char* testDestroy(void)
+{
+	massert(points != NULL, "Invalid file vector");
+	points->destroy(points);
+
+	points = AStruct->ANew(AFileVector, PATH, AFILEVECTOR_READ);
+	massert(points != NULL && points->size == 0, "Cleared file isn't empty");
+	points->destroy(points);
+	massert(remove(PATH) == 0, "Failed to remove file");
+
+	return NULL;
+}
+
+mrun(testCreate, testAppend, testReopen, testDestroy);
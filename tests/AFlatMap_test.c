@@ -0,0 +1,157 @@
+#include "minunit.h"
+#include "AFlatMap.h"
+
+static AFlatMap* map = NULL;
+static int keys[100];
+static int values[100];
+
+const char* testCreate(void)
+{
+	size_t i;
+
+	massert(AStruct->ANew(AFlatMap) == NULL, "Created flat map without comparison function");
+	map = AStruct->ANew(AFlatMap, AComp->intComp, NULL, NULL, 10);
+	massert(map != NULL, "Failed to create flat map");
+
+	for (i = 0; i < ARR_SIZE(keys); i++)
+	{
+		keys[i] = (int)i;
+		values[i] = (int)i * 10;
+	}
+
+	return NULL;
+}
+
+const char* testDestroy(void)
+{
+	massert(map != NULL, "Invalid flat map");
+	map->destroy(map);
+
+	return NULL;
+}
+
+const char* testSetGet(void)
+{
+	size_t i;
+
+	/* Odd keys, inserted backwards */
+	for (i = ARR_SIZE(keys); i > 0; i--)
+	{
+		if (i % 2 == 0)
+		{
+			massert(map->set(map, &keys[i - 1], &values[i - 1]) != NULL, "Failed to set key");
+		}
+	}
+
+	massert(map->size == ARR_SIZE(keys) / 2, "Wrong size after set");
+	massert(map->set(map, &keys[1], &values[0])->value == &values[0], "Failed to replace value");
+	massert(map->size == ARR_SIZE(keys) / 2, "Replacing a value changed the size");
+	map->set(map, &keys[1], &values[1]);
+
+	for (i = 0; i < ARR_SIZE(keys); i++)
+	{
+		massert(map->get(map, &keys[i]) == (i % 2 ? &values[i] : NULL), "Wrong value for key");
+	}
+
+	return NULL;
+}
+
+const char* testRange(void)
+{
+	size_t count, i;
+	APair** pairs = map->range(map, &keys[10], &keys[20], &count);
+
+	massert(count == 5, "Wrong number of entries in range");
+
+	for (i = 0; i < count; i++)
+	{
+		massert(*(int *)pairs[i]->key == 11 + 2 * (int)i, "Wrong entries in range");
+	}
+
+	map->range(map, &keys[20], &keys[10], &count);
+	massert(count == 0, "Got entries of an empty range");
+
+	return NULL;
+}
+
+const char* testMerge(void)
+{
+	APair batch[ARR_SIZE(keys) / 2 + 1];
+	size_t i;
+
+	/* Even keys, and the last key twice */
+	for (i = 0; i < ARR_SIZE(keys) / 2; i++)
+	{
+		batch[i].key = &keys[2 * i];
+		batch[i].value = &values[2 * i];
+	}
+
+	batch[i].key = &keys[2 * i - 2];
+	batch[i].value = &values[0];
+
+	massert(map->merge(map, batch, ARR_SIZE(batch)) == map, "Failed to merge");
+	massert(map->size == ARR_SIZE(keys), "Wrong size after merge");
+
+	for (i = 0; i < ARR_SIZE(keys) - 2; i++)
+	{
+		massert(map->get(map, &keys[i]) == &values[i], "Wrong value after merge");
+	}
+
+	massert(map->get(map, &keys[ARR_SIZE(keys) - 2]) == &values[0], "Later pair of the same key didn't win");
+
+	/* An unsorted batch */
+	batch[0].key = &keys[5];
+	batch[1].key = &keys[3];
+	massert(map->merge(map, batch, 2) == map, "Failed to merge unsorted pairs");
+	massert(map->get(map, &keys[3]) == batch[1].value, "Wrong value after unsorted merge");
+
+	return NULL;
+}
+
+const char* testRemove(void)
+{
+	size_t i;
+
+	for (i = 0; i < ARR_SIZE(keys); i += 2)
+	{
+		map->remove(map, &keys[i]);
+	}
+
+	map->remove(map, &keys[0]);
+	massert(map->size == ARR_SIZE(keys) / 2, "Wrong size after remove");
+	massert(map->get(map, &keys[2]) == NULL && map->get(map, &keys[99]) == &values[99], "Wrong value after remove");
+
+	map->clear(map);
+	massert(map->size == 0 && map->get(map, &keys[99]) == NULL, "Failed to clear");
+
+	return NULL;
+}
+
+static int reverseComp(const void* a, const void* b)
+{
+	return AComp->intComp(b, a);
+}
+
+const char* testReplaceComp(void)
+{
+	APair** pairs;
+	size_t i, count;
+
+	map->comp = reverseComp; /* the map is empty, so it's sorted in any order */
+
+	for (i = 0; i < 10; i++)
+	{
+		massert(map->set(map, &keys[i], &values[i]) != NULL, "Failed to set key");
+	}
+
+	massert(map->keyComp.kind == AKeyCustom, "Wrong kind after replacing the comparison function");
+	pairs = map->range(map, &keys[9], &keys[4], &count);
+	massert(count == 5 && pairs[0]->key == &keys[9] && pairs[4]->key == &keys[5], "Wrong range in reverse order");
+
+	map->clear(map);
+	map->comp = AComp->intComp;
+
+	return NULL;
+}
+
+mrun(testCreate, testSetGet, testRange, testMerge, testRemove, testReplaceComp, testDestroy);
@@ -0,0 +1,175 @@
+#include "minunit.h"
+#include <stdlib.h>
+#include "AHash.h"
+
+char testData[] = "The quick brown fox jumps over the lazy dog";
+
+static size_t streamHash(const void* data, size_t size)
+{
+	AHashState state;
+
+	AHash->init(&state);
+	AHash->update(&state, data, size);
+	return AHash->final(&state);
+}
+
+const char* testStream(void)
+{
+	size_t size = strlen(testData);
+	size_t whole = streamHash(testData, size);
+	size_t i, j;
+
+	for (i = 0; i <= size; i++)
+	{
+		for (j = i; j <= size; j++)
+		{
+			AHashState state;
+
+			AHash->init(&state);
+			AHash->update(&state, testData, i);
+			AHash->update(&state, testData + i, j - i);
+			AHash->update(&state, testData + j, size - j);
+			massert(AHash->final(&state) == whole, "Fragmented hash differs from one-shot hash");
+		}
+	}
+
+	massert(streamHash(testData, size - 1) != whole, "Same hash for different lengths");
+	massert(streamHash("", 0) != streamHash("\0", 1), "Same hash for zero padding");
+
+	return NULL;
+}
+
+const char* testCombine(void)
+{
+	size_t a = AHash->stringHash("foo");
+	size_t b = AHash->stringHash("bar");
+
+	massert(AHash->combine(AHash->combine(0, a), b) == AHash->combine(AHash->combine(0, a), b),
+			"Combine isn't deterministic");
+	massert(AHash->combine(AHash->combine(0, a), b) != AHash->combine(AHash->combine(0, b), a),
+			"Combine doesn't depend on order");
+
+	return NULL;
+}
+
+const char* testDistribution(void)
+{
+	size_t buckets[64] = { 0 };
+	size_t i;
+
+	for (i = 0; i < 64 * 64; i++)
+	{
+		buckets[AHash->combine(0, AHash->combine(0, i)) & 63]++;
+		buckets[streamHash(&i, sizeof i) & 63]++;
+	}
+
+	for (i = 0; i < ARR_SIZE(buckets); i++)
+	{
+		massert(buckets[i] > 64 && buckets[i] < 3 * 64, "Badly distributed hash values");
+	}
+
+	return NULL;
+}
+
+const char* testStringHash(void)
+{
+	const size_t PAGE = 4096;
+	char* buffer = malloc(3 * PAGE);
+	char* page = buffer + PAGE - (size_t)buffer % PAGE; /* start of a page inside the buffer */
+	size_t start, size;
+
+	massert(buffer != NULL, "Failed to allocate buffer");
+
+	/* Strings of any alignment and length, ending before, at and after a page boundary */
+	for (start = PAGE - 40; start < PAGE + 8; start++)
+	{
+		for (size = 0; start + size < PAGE + 16; size++)
+		{
+			size_t length = 0;
+
+			memset(page + start, 'x', size);
+			page[start + size] = '\0';
+
+			massert(AHash->stringHashLength(page + start, &length) == streamHash(page + start, size),
+					"String hash differs from incremental hash");
+			massert(length == size, "Wrong string length");
+			massert(AHash->stringHash(page + start) == streamHash(page + start, size),
+					"String hash differs from incremental hash");
+			{
+				AString string = { page + start, size };
+				massert(AHash->astringHash(&string) == streamHash(page + start, size),
+						"Sized string hash differs from incremental hash");
+			}
+		}
+	}
+
+	free(buffer);
+
+	/* Sized strings which fill their buffers exactly are read only up to their lengths */
+	for (size = 0; size < 24; size++)
+	{
+		AString string;
+
+		massert((buffer = malloc(size + 1)) != NULL, "Failed to allocate buffer");
+		memcpy(buffer, testData, size);
+		string.data = buffer;
+		string.length = size;
+
+		massert(AHash->astringHash(&string) == streamHash(testData, size), "Sized string hash differs from incremental hash");
+		free(buffer);
+	}
+
+	return NULL;
+}
+
+const char* testHashBatch(void)
+{
+	size_t size, count, i;
+	size_t hashes[ARR_SIZE(testData)];
+
+	for (size = 0; size <= 20; size++)
+	{
+		for (count = 0; count * size < sizeof testData && count < ARR_SIZE(hashes); count++)
+		{
+			AHash->hashBatch(testData, size, count, hashes);
+
+			for (i = 0; i < count; i++)
+			{
+				massert(hashes[i] == AHash->hash(testData + i * size, size), "Wrong batch hash value");
+			}
+		}
+	}
+
+	return NULL;
+}
+
+const char* testStringHashBatch(void)
+{
+	const char* strings[ARR_SIZE(testData)];
+	size_t sizes[ARR_SIZE(testData)];
+	size_t hashes[ARR_SIZE(testData)];
+	size_t count = ARR_SIZE(testData) - 1;
+	size_t i;
+
+	for (i = 0; i < count; i++)
+	{
+		strings[i] = testData + (i * 7) % count;
+		sizes[i] = strlen(strings[i]);
+	}
+
+	AHash->stringHashBatch(strings, NULL, count, hashes);
+	for (i = 0; i < count; i++)
+	{
+		massert(hashes[i] == AHash->stringHash(strings[i]), "Wrong batch string hash value");
+	}
+
+	AHash->stringHashBatch(strings, sizes, count, hashes);
+	for (i = 0; i < count; i++)
+	{
+		massert(hashes[i] == AHash->stringHash(strings[i]), "Wrong batch string hash value with sizes");
+	}
+
+	return NULL;
+}
+
+mrun(testStream, testCombine, testDistribution, testStringHash, testHashBatch, testStringHashBatch);
@@ -99,4 +99,90 @@ const char* testRemove(void)
 	return NULL;
 }
 
-mrun(testCreate, testSet, testGet, testTraverse, testRemove, testDestroy);
+size_t longHash(const void* key)
+{
+	return AHash->hash(key, sizeof(long long));
+}
+
+const char* testKeyKinds(void)
+{
+	int ints[100];
+	long long longs[100];
+	int one = 1;
+	AHashtable* intTable = AStruct->ANew(AHashtable, AHash->intHash, AComp->intComp);
+	AHashtable* longTable = AStruct->ANew(AHashtable, longHash, AComp->int64Comp);
+	AHashtable* pointerTable = AStruct->ANew(AHashtable, AHash->pointerHash, AComp->pointerComp);
+	size_t i;
+
+	massert(intTable != NULL && longTable != NULL && pointerTable != NULL, "Failed to create hash tables");
+	massert(intTable->keyComp.kind == AKeyInt32, "Wrong kind of int keys");
+	massert(longTable->keyComp.kind == AKeyInt64, "Wrong kind of long long keys");
+	massert(pointerTable->keyComp.kind == AKeyPointer, "Wrong kind of pointer keys");
+	massert(hashtable->keyComp.kind == AKeyString, "Wrong kind of string keys");
+
+	for (i = 0; i < ARR_SIZE(ints); i++)
+	{
+		ints[i] = (int)i;
+		longs[i] = (long long)i << 40;
+		massert(intTable->set(intTable, &ints[i], &longs[i]) != NULL, "Failed to set int key");
+		massert(longTable->set(longTable, &longs[i], &ints[i]) != NULL, "Failed to set long long key");
+		massert(pointerTable->set(pointerTable, &ints[i], &longs[i]) != NULL, "Failed to set pointer key");
+	}
+
+	for (i = 0; i < ARR_SIZE(ints); i++)
+	{
+		int key = (int)i;
+		long long longKey = (long long)i << 40;
+		massert(intTable->get(intTable, &key) == &longs[i], "Wrong value for int key");
+		massert(longTable->get(longTable, &longKey) == &ints[i], "Wrong value for long long key");
+		massert(pointerTable->get(pointerTable, &ints[i]) == &longs[i], "Wrong value for pointer key");
+		massert(pointerTable->get(pointerTable, &key) == NULL, "Pointer keys compared by value");
+	}
+
+	intTable->remove(intTable, &ints[0]);
+	intTable->remove(intTable, &ints[0]); /* removing a missing key does nothing */
+	massert(intTable->get(intTable, &ints[0]) == NULL, "Int key wasn't removed");
+
+	intTable->comp = AComp->pointerComp; /* the kind follows a replaced comparison function */
+	massert(intTable->get(intTable, &ints[1]) == &longs[1], "Wrong value for the same pointer");
+	massert(intTable->get(intTable, &one) == NULL, "Int keys still compared by value");
+	massert(intTable->keyComp.kind == AKeyPointer, "Wrong kind after replacing the comparison function");
+
+	intTable->destroy(intTable);
+	longTable->destroy(longTable);
+	pointerTable->destroy(pointerTable);
+
+	return NULL;
+}
+
+const char* testAStringKeys(void)
+{
+	AString keys[ARR_SIZE(testData)];
+	AHashtable* table = AStruct->ANew(AHashtable, AHash->astringHash, AComp->astringComp);
+	size_t i;
+
+	massert(table != NULL, "Failed to create hash table");
+	massert(table->keyComp.kind == AKeyAString, "Wrong kind of sized string keys");
+
+	for (i = 0; i < ARR_SIZE(testData); i++)
+	{
+		keys[i].data = testData[i].key;
+		keys[i].length = strlen(testData[i].key);
+		massert(table->set(table, &keys[i], testData[i].value) != NULL, "Failed to set sized string key");
+	}
+
+	for (i = 0; i < ARR_SIZE(testData); i++)
+	{
+		AString key = { testData[i].key, keys[i].length };
+		massert(table->get(table, &key) == testData[i].value, "Wrong value for sized string key");
+
+		key.length--;
+		massert(table->get(table, &key) == NULL, "Found a prefix of a sized string key");
+	}
+
+	table->destroy(table);
+
+	return NULL;
+}
+
+mrun(testCreate, testSet, testGet, testTraverse, testKeyKinds, testAStringKeys, testRemove, testDestroy);
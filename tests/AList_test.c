@@ -139,7 +139,7 @@ const char* testCopySplitJoin(void)
 				"Wrong values after split");
 	}
 
-	copy->join(copy, copySplit);
+	massert(copy->join(copy, copySplit) == copy, "Failed to join");
 	massert(copy->size == list->size, "Wrong size after join");
 	for (copyNode = copy->head; i < copy->size; copyNode = copyNode->next, i++)
 	{
@@ -151,4 +151,71 @@ const char* testCopySplitJoin(void)
 	return NULL;
 }
 
-mrun(testCreate, testAppend, testPrepend, testInsert, testRemove, testCopySplitJoin, testDestroy);
+const char* testPool(void)
+{
+	AListPool* pool = AStruct->ANew(AListPool);
+	AList* first;
+	AList* second;
+	AList* copy;
+	AListNode* node;
+	AListNode* removed;
+	size_t i, n = 100;
+	size_t dataSize = ARR_SIZE(testData);
+
+	massert(pool != NULL, "Failed to create pool");
+	first = AStruct->ANew(AList, pool);
+	second = AStruct->ANew(AList, pool);
+	massert(first != NULL && second != NULL, "Failed to create lists with a pool");
+	pool->destroy(pool); /* The lists keep it */
+
+	for (i = 0; i < n; i++)
+	{
+		massert(first->append(first, testData[i % dataSize]) != NULL, "Failed to append");
+		massert(second->prepend(second, testData[i % dataSize]) != NULL, "Failed to prepend");
+	}
+
+	/* A removed node is reused by the next list which needs one */
+	removed = first->head->next;
+	massert(first->remove(first, removed) == testData[1], "Wrong value on remove");
+	massert(second->append(second, testData[0]) == removed, "Removed node wasn't reused");
+
+	/* The copy is one block in the order of the list */
+	copy = first->copy(first, NULL);
+	massert(copy != NULL && copy->size == first->size, "Wrong size after copy");
+	for (node = first->head, i = 0; node != NULL; node = node->next, i++)
+	{
+		massert(i == 0 || copy->head[i - 1].next == &copy->head[i], "Copy isn't in order");
+		massert(copy->head[i].value == node->value, "Wrong values after copy");
+	}
+	massert(copy->tail == copy->head + copy->size - 1, "Wrong tail after copy");
+
+	/* Join a list with a pool of its own, then lists sharing a pool with another list */
+	massert(first->join(first, copy) == first, "Failed to join a copy");
+	massert(first->size == 2 * (n - 1), "Wrong size after joining a copy");
+	copy = second->copy(second, NULL);
+	massert(copy != NULL, "Failed to copy");
+	massert(copy->join(copy, second) == copy, "Failed to join a shared pool");
+	massert(copy->size == 2 * (n + 1), "Wrong size after joining a shared pool");
+	for (node = copy->head, i = 0; node != NULL; node = node->next, i++)
+	{
+		massert(node->value == copy->valueAt(copy, i % (n + 1)), "Wrong values after join");
+	}
+	massert(i == copy->size && copy->tail->next == NULL, "Wrong links after join");
+
+	second = first->splitAt(first, n - 1);
+	massert(second != NULL && second->pool == first->pool, "Split list doesn't share the pool");
+	massert(first->join(first, second) == first, "Failed to join");
+	massert(first->size == 2 * (n - 1), "Wrong size after join");
+
+	/* Clearing a list with a pool of its own frees the slabs, and the next ones start small again */
+	first->clear(first, NULL);
+	massert(first->pool->slabCapacity == 8, "Slabs didn't start small after clear");
+	massert(first->append(first, testData[0]) != NULL && first->size == 1, "Failed to append after clear");
+
+	copy->destroy(copy, NULL);
+	first->destroy(first, NULL);
+
+	return NULL;
+}
+
+mrun(testCreate, testAppend, testPrepend, testInsert, testRemove, testCopySplitJoin, testPool, testDestroy);
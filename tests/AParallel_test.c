@@ -0,0 +1,148 @@
+#include "minunit.h"
+#include "AParallel.h"
+
+#define NUM_TASKS 1000
+
+static void square(void* arg, size_t index)
+{
+	size_t* results = arg;
+	results[index] = index * index;
+}
+
+const char* testThreads(void)
+{
+	massert(AParallel->threads() >= 1, "No threads by default");
+	AParallel->setThreads(3);
+	massert(AParallel->threads() == 3, "Failed to set threads");
+
+	return NULL;
+}
+
+const char* testRun(void)
+{
+	static size_t results[NUM_TASKS];
+	size_t threads[] = { 1, 3, 8 };
+	size_t i, t;
+
+	for (t = 0; t < ARR_SIZE(threads); t++)
+	{
+		AParallel->setThreads(threads[t]);
+
+		for (i = 0; i < NUM_TASKS; i++)
+		{
+			results[i] = 0;
+		}
+
+		AParallel->run(square, results, NUM_TASKS);
+
+		for (i = 0; i < NUM_TASKS; i++)
+		{
+			massert(results[i] == i * i, "Task didn't run");
+		}
+	}
+
+	AParallel->run(square, NULL, 0);
+	AParallel->setThreads(0);
+
+	return NULL;
+}
+
+static void nested(void* arg, size_t index)
+{
+	size_t* results = arg;
+	AParallel->run(square, results + index * 10, 10);
+}
+
+const char* testPool(void)
+{
+	static size_t results[NUM_TASKS];
+	size_t i, round;
+
+	/* The workers are reused, and restarted when the number of threads changes */
+	for (round = 0; round < 20; round++)
+	{
+		AParallel->setThreads(round % 5 + 1);
+
+		for (i = 0; i < NUM_TASKS; i++)
+		{
+			results[i] = 0;
+		}
+
+		AParallel->run(nested, results, NUM_TASKS / 10);
+
+		for (i = 0; i < NUM_TASKS; i++)
+		{
+			massert(results[i] == (i % 10) * (i % 10), "Nested task didn't run");
+		}
+	}
+
+	AParallel->setThreads(0);
+
+	return NULL;
+}
+
+static void resize(void* arg, size_t index)
+{
+	size_t* results = arg;
+
+	AParallel->setThreads(index % 4 + 1);
+	results[index] = AParallel->threads();
+}
+
+const char* testSetThreadsWhileRunning(void)
+{
+	static size_t results[NUM_TASKS];
+	size_t i;
+
+	/* Tasks change the number of threads of the work they run in */
+	AParallel->setThreads(4);
+	AParallel->run(resize, results, NUM_TASKS);
+
+	for (i = 0; i < NUM_TASKS; i++)
+	{
+		massert(results[i] >= 1 && results[i] <= 4, "Wrong number of threads");
+		results[i] = 0;
+	}
+
+	AParallel->run(square, results, NUM_TASKS);
+
+	for (i = 0; i < NUM_TASKS; i++)
+	{
+		massert(results[i] == i * i, "Task didn't run after changing the threads");
+	}
+
+	AParallel->setThreads(0);
+
+	return NULL;
+}
+
+const char* testShutdown(void)
+{
+	static size_t results[NUM_TASKS];
+	size_t i;
+
+	/* The threads start again after a shutdown */
+	AParallel->setThreads(4);
+	AParallel->run(square, results, NUM_TASKS);
+	AParallel->shutdown();
+	AParallel->shutdown();
+
+	for (i = 0; i < NUM_TASKS; i++)
+	{
+		results[i] = 0;
+	}
+
+	AParallel->run(square, results, NUM_TASKS);
+
+	for (i = 0; i < NUM_TASKS; i++)
+	{
+		massert(results[i] == i * i, "Task didn't run after shutdown");
+	}
+
+	AParallel->setThreads(0);
+	AParallel->shutdown();
+
+	return NULL;
+}
+
+mrun(testThreads, testRun, testPool, testSetThreadsWhileRunning, testShutdown);
@@ -0,0 +1,81 @@
+#include "minunit.h"
+#include "ASegmentedVector.h"
+
+#define NUM_VALUES 10000
+
+static ASegmentedVector* vector = NULL;
+static int numbers[NUM_VALUES];
+static void** handles[NUM_VALUES];
+
+const char* testCreate(void)
+{
+	vector = AStruct->ANew(ASegmentedVector);
+	massert(vector != NULL, "Failed to create segmented vector");
+	massert(vector->size == 0, "Wrong size after creation");
+
+	return NULL;
+}
+
+const char* testDestroy(void)
+{
+	massert(vector != NULL, "Invalid segmented vector");
+	vector->destroy(vector, NULL);
+
+	return NULL;
+}
+
+const char* testAppend(void)
+{
+	size_t i;
+
+	for (i = 0; i < NUM_VALUES; i++)
+	{
+		numbers[i] = (int)i;
+		handles[i] = vector->append(vector, &numbers[i]);
+		massert(handles[i] != NULL, "Failed to append");
+	}
+
+	massert(vector->size == NUM_VALUES, "Wrong size after append");
+
+	for (i = 0; i < NUM_VALUES; i++)
+	{
+		massert(*handles[i] == &numbers[i], "Value moved while growing");
+		massert(vector->at(vector, i) == handles[i], "Wrong address of a value");
+		massert(vector->get(vector, i) == &numbers[i], "Wrong value after append");
+	}
+
+	massert(vector->get(vector, NUM_VALUES) == NULL, "Got a value past the end");
+
+	return NULL;
+}
+
+const char* testSet(void)
+{
+	massert(vector->set(vector, 5, &numbers[0]) == handles[5], "Failed to set");
+	massert(vector->get(vector, 5) == &numbers[0], "Wrong value after set");
+	massert(vector->set(vector, 5, &numbers[5]) != NULL, "Failed to set");
+	massert(vector->set(vector, NUM_VALUES + 1, &numbers[0]) == NULL, "Set invalid position");
+
+	return NULL;
+}
+
+const char* testRemoveLast(void)
+{
+	size_t i;
+
+	for (i = NUM_VALUES; i > NUM_VALUES / 2; i--)
+	{
+		massert(vector->removeLast(vector) == &numbers[i - 1], "Wrong value removed");
+	}
+
+	massert(vector->size == NUM_VALUES / 2, "Wrong size after remove");
+	massert(vector->append(vector, &numbers[0]) == handles[NUM_VALUES / 2], "Blocks weren't reused");
+	massert(vector->reserve(vector, 100000) == vector, "Failed to reserve");
+
+	vector->clear(vector, NULL);
+	massert(vector->size == 0 && vector->removeLast(vector) == NULL, "Failed to clear");
+
+	return NULL;
+}
+
+mrun(testCreate, testAppend, testSet, testRemoveLast, testDestroy);
@@ -54,4 +54,34 @@ const char* testPop(void)
 	return NULL;
 }
 
-mrun(testCreate, testPushTop, testPop, testDestroy);
+const char* testShrink(void)
+{
+	AVectorGrowth growth = { 2, 0, 0.25 };
+	size_t i;
+
+	stack->setGrowth(stack, growth);
+
+	for (i = 0; i < 1000; i++)
+	{
+		massert(stack->push(stack, testData[i % ARR_SIZE(testData)]) != NULL, "Failed to push");
+	}
+
+	massert(stack->stack->capacity >= 1000, "Wrong capacity after push");
+
+	while (stack->size > 10)
+	{
+		stack->pop(stack);
+	}
+
+	massert(stack->stack->capacity < 100, "Stack didn't shrink after pop");
+	massert(stack->top(stack) == testData[9 % ARR_SIZE(testData)], "Wrong top value after shrink");
+
+	while (stack->size > 0)
+	{
+		stack->pop(stack);
+	}
+
+	return NULL;
+}
+
+mrun(testCreate, testPushTop, testPop, testShrink, testDestroy);
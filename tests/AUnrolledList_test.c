@@ -0,0 +1,148 @@
+#include "minunit.h"
+#include "AUnrolledList.h"
+
+#define NUM_VALUES 1000
+
+static AUnrolledList* list = NULL;
+
+/* Check the list holds 0 .. size - 1 (in steps of 'step'), and that its nodes are linked and not empty */
+static int isSequence(AUnrolledList* self, size_t step)
+{
+	AUnrolledListNode* node;
+	size_t i, expected = 0, count = 0;
+
+	for (node = self->head; node != NULL; node = node->next)
+	{
+		if (node->count == 0 || node->count > AUNROLLEDLIST_VALUES ||
+		    (node->next != NULL ? node->next->prev != node : self->tail != node))
+		{
+			return 0;
+		}
+
+		for (i = 0; i < node->count; i++, count++, expected += step)
+		{
+			if (node->values[i] != (void *)expected)
+			{
+				return 0;
+			}
+		}
+	}
+
+	return count == self->size;
+}
+
+const char* testCreate(void)
+{
+	list = AStruct->ANew(AUnrolledList);
+	massert(list != NULL && list->size == 0 && list->head == NULL, "Failed to create list");
+
+	return NULL;
+}
+
+const char* testDestroy(void)
+{
+	massert(list != NULL, "Invalid list");
+	list->destroy(list, NULL);
+
+	return NULL;
+}
+
+const char* testAppendPrepend(void)
+{
+	size_t i;
+
+	for (i = 0; i < NUM_VALUES; i++)
+	{
+		massert(list->append(list, (void *)(NUM_VALUES + i)) == list, "Failed to append");
+		massert(list->prepend(list, (void *)(NUM_VALUES - 1 - i)) == list, "Failed to prepend");
+	}
+
+	massert(list->size == 2 * NUM_VALUES && isSequence(list, 1), "Wrong values after append and prepend");
+	massert(list->first(list) == (void *)0 && list->last(list) == (void *)(2 * NUM_VALUES - 1), "Wrong first or last");
+
+	for (i = 0; i < list->size; i++)
+	{
+		massert(list->valueAt(list, i) == (void *)i, "Wrong value on valueAt");
+	}
+
+	massert(list->valueAt(list, list->size) == NULL, "Got value past the end");
+
+	for (i = 0; i < NUM_VALUES; i++)
+	{
+		massert(list->popFirst(list) == (void *)i, "Wrong value on popFirst");
+		massert(list->popLast(list) == (void *)(2 * NUM_VALUES - 1 - i), "Wrong value on popLast");
+	}
+
+	massert(list->size == 0 && list->head == NULL && list->tail == NULL, "List isn't empty");
+	massert(list->popFirst(list) == NULL && list->popLast(list) == NULL, "Popped from an empty list");
+
+	return NULL;
+}
+
+const char* testInsertRemove(void)
+{
+	size_t i;
+
+	/* Insert the odd values between the even ones, splitting the nodes */
+	for (i = 0; i < NUM_VALUES; i++)
+	{
+		massert(list->append(list, (void *)(2 * i)) == list, "Failed to append");
+	}
+
+	for (i = 0; i < NUM_VALUES; i++)
+	{
+		massert(list->insertAt(list, 2 * i + 1, (void *)(2 * i + 1)) == list, "Failed to insertAt");
+	}
+
+	massert(list->insertAt(list, list->size + 1, NULL) == NULL, "Inserted past the end");
+	massert(list->size == 2 * NUM_VALUES && isSequence(list, 1), "Wrong values after insertAt");
+
+	massert(list->replaceAt(list, 7, (void *)70) == (void *)7, "Failed to replaceAt");
+	massert(list->replaceAt(list, 7, (void *)7) == (void *)70, "Wrong value on replaceAt");
+
+	/* Remove the odd values, merging the nodes */
+	for (i = 1; i <= NUM_VALUES; i++)
+	{
+		massert(list->removeAt(list, i) == (void *)(2 * i - 1), "Wrong value on removeAt");
+	}
+
+	massert(list->removeAt(list, list->size) == NULL, "Removed past the end");
+	massert(list->size == NUM_VALUES && isSequence(list, 2), "Wrong values after removeAt");
+
+	return NULL;
+}
+
+static void* half(void* value)
+{
+	return (void *)((size_t)value / 2);
+}
+
+const char* testCopy(void)
+{
+	AUnrolledList* copy = list->copy(list, NULL);
+	AUnrolledListNode* node;
+
+	massert(copy != NULL && copy->size == list->size && isSequence(copy, 2), "Wrong values after copy");
+
+	for (node = copy->head; node != copy->tail; node = node->next)
+	{
+		massert(node->count == AUNROLLEDLIST_VALUES, "Copy isn't packed");
+	}
+
+	copy->destroy(copy, NULL);
+
+	copy = list->copy(list, half);
+	massert(copy != NULL && copy->size == list->size && isSequence(copy, 1), "Wrong values after copy with copyValue");
+	copy->destroy(copy, NULL);
+
+	list->clear(list, NULL);
+	massert(list->size == 0 && list->head == NULL, "Failed to clear");
+
+	copy = list->copy(list, half);
+	massert(copy != NULL && copy->size == 0 && copy->head == NULL && copy->tail == NULL, "Wrong copy of empty list");
+	copy->destroy(copy, NULL);
+
+	return NULL;
+}
+
+mrun(testCreate, testAppendPrepend, testInsertRemove, testCopy, testDestroy);
@@ -1,6 +1,7 @@
 #include "minunit.h"
 #include <stdlib.h>
 #include "AVector.h"
+#include "AParallel.h"
 
 static AVector* vector = NULL;
 char testData[][4] = { "foo", "bar", "baz", "bug" };
@@ -164,5 +165,539 @@ const char* testCopyJoin(void)
 	return testGet();
 }
 
-mrun(testCreate, testAppend, testInsert, testReplace, testSet,
+int isOdd(void* value)
+{
+	return *(int *)value % 2 != 0;
+}
+
+const char* testRanges(void)
+{
+	int numbers[10];
+	void* values[ARR_SIZE(numbers)];
+	AVector* ranges = AStruct->ANew(AVector, 1);
+	size_t i;
+
+	for (i = 0; i < ARR_SIZE(numbers); i++)
+	{
+		numbers[i] = (int)i;
+		values[i] = &numbers[i];
+	}
+
+	massert(ranges->insertRange(ranges, 0, values + 5, 5) != NULL, "Failed to insert range");
+	massert(ranges->insertRange(ranges, 0, values, 3) != NULL, "Failed to insert range at the start");
+	massert(ranges->insertRange(ranges, 3, values + 3, 2) != NULL, "Failed to insert range in the middle");
+	massert(ranges->insertRange(ranges, 11, values, 1) == NULL, "Inserted range at invalid position");
+	massert(ranges->size == ARR_SIZE(numbers), "Wrong size after insert range");
+
+	for (i = 0; i < ranges->size; i++)
+	{
+		massert(ranges->get(ranges, i) == values[i], "Wrong value after insert range");
+	}
+
+	massert(ranges->eraseRange(ranges, 2, 3, NULL) == 3, "Failed to erase range");
+	massert(ranges->size == 7 && *(int *)ranges->get(ranges, 2) == 5, "Wrong values after erase range");
+	massert(ranges->eraseRange(ranges, 5, 100, NULL) == 2, "Failed to erase range until the end");
+	massert(ranges->size == 5 && *(int *)ranges->get(ranges, 4) == 7, "Wrong values after erase range");
+
+	massert(ranges->removeIf(ranges, isOdd, NULL) == 3, "Wrong number of removed values");
+	massert(ranges->size == 2, "Wrong size after remove if");
+	massert(*(int *)ranges->get(ranges, 0) == 0 && *(int *)ranges->get(ranges, 1) == 6, "Wrong values after remove if");
+
+	ranges->destroy(ranges, NULL);
+
+	return NULL;
+}
+
+const char* testBulkAppend(void)
+{
+	int numbers[100];
+	void* values[ARR_SIZE(numbers)];
+	AVector* bulk = AStruct->ANew(AVector, 1);
+	AVector* other = AStruct->ANew(AVector);
+	size_t i;
+
+	for (i = 0; i < ARR_SIZE(numbers); i++)
+	{
+		numbers[i] = (int)i;
+		values[i] = &numbers[i];
+	}
+
+	massert(bulk->appendArray(bulk, values, ARR_SIZE(values)) != NULL, "Failed to append array");
+	massert(bulk->size == ARR_SIZE(values), "Wrong size after append array");
+	massert(bulk->capacity == 128, "Vector wasn't expanded once");
+	massert(other->appendN(other, values[0], 3) != NULL, "Failed to append a value several times");
+	massert(other->size == 3 && other->get(other, 2) == values[0], "Wrong values after append N");
+
+	massert(bulk->extend(bulk, other) == bulk, "Failed to extend");
+	massert(bulk->extend(bulk, bulk) == bulk, "Failed to extend with itself");
+	massert(bulk->size == 2 * (ARR_SIZE(values) + 3), "Wrong size after extend");
+
+	for (i = 0; i < bulk->size; i++)
+	{
+		size_t j = i % (ARR_SIZE(values) + 3);
+		massert(bulk->get(bulk, i) == values[j < ARR_SIZE(values) ? j : 0], "Wrong value after extend");
+	}
+
+	massert(other->size == 3, "Extend changed the other vector");
+	other->destroy(other, NULL);
+	bulk->destroy(bulk, NULL);
+
+	return NULL;
+}
+
+const char* testGrowth(void)
+{
+	AVectorGrowth growth = { 1.5, 100, 0.2 };
+	AVector* grown = AStruct->ANew(AVector, 16);
+	size_t i;
+
+	massert(grown->growth.factor == 2 && grown->growth.shrinkBelow == 0, "Wrong default growth policy");
+	grown->growth = growth;
+
+	massert(grown->appendN(grown, NULL, 17) != NULL && grown->capacity == 24, "Didn't grow by factor");
+	massert(grown->appendN(grown, NULL, 100) != NULL && grown->capacity == 121, "Didn't grow by factor");
+	massert(grown->appendN(grown, NULL, 10) != NULL && grown->capacity == 221, "Didn't grow by chunk");
+
+	massert(grown->reserve(grown, 1000) == grown && grown->capacity == 1000, "Failed to reserve");
+	massert(grown->reserve(grown, 10) == grown && grown->capacity == 1000, "Reserve shrank the vector");
+	massert(grown->shrinkToFit(grown) == grown && grown->capacity == grown->size, "Failed to shrink to fit");
+
+	for (i = grown->size; i > 0; i--)
+	{
+		grown->remove(grown, 0);
+		massert(grown->capacity <= AVECTOR_LOCAL_CAPACITY || grown->size >= grown->capacity * growth.shrinkBelow, "Vector didn't shrink");
+	}
+
+	massert(grown->capacity == AVECTOR_LOCAL_CAPACITY && grown->values == grown->storage.local,
+	        "Vector didn't shrink back into its local storage");
+	grown->destroy(grown, NULL);
+
+	return NULL;
+}
+
+const char* testLocalStorage(void)
+{
+	int numbers[AVECTOR_LOCAL_CAPACITY + 1];
+	AVector* small = AStruct->ANew(AVector);
+	size_t i;
+
+	massert(small->values == small->storage.local && small->capacity == AVECTOR_LOCAL_CAPACITY,
+	        "Small vector doesn't use its own storage");
+
+	for (i = 0; i < ARR_SIZE(numbers); i++)
+	{
+		numbers[i] = (int)i;
+		massert(small->append(small, &numbers[i]) != NULL, "Failed to append");
+		massert((small->values == small->storage.local) == (i < AVECTOR_LOCAL_CAPACITY), "Wrong storage after append");
+	}
+
+	for (i = 0; i < ARR_SIZE(numbers); i++)
+	{
+		massert(small->get(small, i) == &numbers[i], "Values weren't moved out of the vector");
+	}
+
+	small->remove(small, 0);
+	massert(small->shrinkToFit(small) == small && small->values == small->storage.local, "Values weren't moved back");
+
+	for (i = 0; i < small->size; i++)
+	{
+		massert(small->get(small, i) == &numbers[i + 1], "Values weren't moved back");
+	}
+
+	small->destroy(small, NULL);
+
+	return NULL;
+}
+
+const char* testMappedStorage(void)
+{
+	AVector* large = AStruct->ANew(AVector);
+	size_t i, count = 1 << 20;
+
+	large->growth.mapAbove = 1 << 12;
+	large->growth.hugePages = 1;
+
+	for (i = 0; i < count; i++)
+	{
+		massert(large->append(large, (void *)i) != NULL, "Failed to append");
+	}
+
+	for (i = 0; i < count; i++)
+	{
+		massert(large->get(large, i) == (void *)i, "Wrong value after growing mapped storage");
+	}
+
+	massert(large->capacity >= count, "Wrong capacity of mapped storage");
+	massert(large->eraseRange(large, 100, count, NULL) == count - 100, "Failed to erase range");
+	massert(large->shrinkToFit(large) == large && large->capacity == 100, "Mapped storage didn't shrink");
+	massert(large->get(large, 99) == (void *)99, "Wrong value after shrinking mapped storage");
+	large->destroy(large, NULL);
+
+	return NULL;
+}
+
+typedef struct Record
+{
+	int key;
+	size_t order;
+} Record;
+
+static int recordComp(const void* a, const void* b)
+{
+	return (((const Record *)a)->key > ((const Record *)b)->key) - (((const Record *)a)->key < ((const Record *)b)->key);
+}
+
+const char* testSort(void)
+{
+	size_t sizes[] = { 0, 1, 10, 1000, 100000 };
+	size_t threads[] = { 1, 3, 4 };
+	size_t i, s, t;
+
+	for (t = 0; t < ARR_SIZE(threads); t++)
+	{
+		AParallel->setThreads(threads[t]);
+
+		for (s = 0; s < ARR_SIZE(sizes); s++)
+		{
+			Record* records = malloc((sizes[s] + 1) * sizeof *records);
+			AVector* sorted = AStruct->ANew(AVector);
+			AVector* stable = AStruct->ANew(AVector);
+
+			srand(1);
+			for (i = 0; i < sizes[s]; i++)
+			{
+				records[i].key = rand() % (s % 2 ? 100 : 1000000); /* Many equal keys, or not */
+				records[i].order = i;
+				sorted->append(sorted, &records[i]);
+				stable->append(stable, &records[i]);
+			}
+
+			massert(sorted->sort(sorted, recordComp) == sorted, "Failed to sort");
+			massert(stable->stableSort(stable, recordComp) == stable, "Failed to stable sort");
+			massert(sorted->size == sizes[s] && stable->size == sizes[s], "Wrong size after sort");
+
+			for (i = 1; i < sizes[s]; i++)
+			{
+				Record* previous = stable->get(stable, i - 1);
+				Record* current = stable->get(stable, i);
+
+				massert(recordComp(sorted->get(sorted, i - 1), sorted->get(sorted, i)) <= 0, "Values aren't sorted");
+				massert(previous->key < current->key ||
+				        (previous->key == current->key && previous->order < current->order), "Sort isn't stable");
+			}
+
+			sorted->destroy(sorted, NULL);
+			stable->destroy(stable, NULL);
+			free(records);
+		}
+	}
+
+	AParallel->setThreads(0);
+
+	return NULL;
+}
+
+static unsigned long long recordKey(const void* record)
+{
+	return (unsigned)((const Record *)record)->key;
+}
+
+const char* testRadixSort(void)
+{
+	size_t sizes[] = { 0, 1, 1000, 100000 };
+	size_t threads[] = { 1, 3 };
+	AVector* invalid;
+	size_t i, s, t;
+
+	for (t = 0; t < ARR_SIZE(threads); t++)
+	{
+		AParallel->setThreads(threads[t]);
+
+		for (s = 0; s < ARR_SIZE(sizes); s++)
+		{
+			Record* records = malloc((sizes[s] + 1) * sizeof *records);
+			AVector* sorted = AStruct->ANew(AVector);
+
+			srand(2);
+			for (i = 0; i < sizes[s]; i++)
+			{
+				records[i].key = rand() % (s % 2 ? 1 << 20 : 1 << 8) + (1 << 24); /* The high byte is the same */
+				records[i].order = i;
+				sorted->append(sorted, &records[i]);
+			}
+
+			massert(sorted->radixSort(sorted, recordKey, 4) == sorted, "Failed to radix sort");
+			massert(sorted->size == sizes[s], "Wrong size after radix sort");
+
+			for (i = 1; i < sizes[s]; i++)
+			{
+				Record* previous = sorted->get(sorted, i - 1);
+				Record* current = sorted->get(sorted, i);
+
+				massert(previous->key < current->key ||
+				        (previous->key == current->key && previous->order < current->order), "Wrong radix sort");
+			}
+
+			sorted->destroy(sorted, NULL);
+			free(records);
+		}
+	}
+
+	AParallel->setThreads(0);
+	invalid = AStruct->ANew(AVector);
+	massert(invalid->radixSort(invalid, recordKey, 9) == NULL, "Radix sorted by keys of an invalid size");
+	invalid->destroy(invalid, NULL);
+
+	return NULL;
+}
+
+/* Compare the length of a string of a vector to a length */
+static int lengthComp(const void* string, const void* length)
+{
+	return (strlen(string) > *(const size_t *)length) - (strlen(string) < *(const size_t *)length);
+}
+
+const char* testBinarySearch(void)
+{
+	int numbers[] = { 1, 3, 3, 3, 5, 8 };
+	int missing[] = { 0, 2, 4, 9 };
+	char* strings[] = { "a", "foo", "bar", "baz", "hello", "abcdefgh" };
+	size_t lengths[] = { 0, 3, 4, 8 };
+	AVector* sorted = AStruct->ANew(AVector);
+	size_t i;
+
+	massert(sorted->lowerBound(sorted, &numbers[0], AComp->intComp) == 0, "Wrong lower bound in empty vector");
+
+	for (i = 0; i < ARR_SIZE(numbers); i++)
+	{
+		sorted->append(sorted, &numbers[i]);
+	}
+
+	massert(sorted->lowerBound(sorted, &numbers[1], AComp->intComp) == 1, "Wrong lower bound");
+	massert(sorted->upperBound(sorted, &numbers[1], AComp->intComp) == 4, "Wrong upper bound");
+	massert(sorted->lowerBound(sorted, &missing[0], AComp->intComp) == 0, "Wrong lower bound before the values");
+	massert(sorted->upperBound(sorted, &missing[3], AComp->intComp) == 6, "Wrong upper bound after the values");
+
+	for (i = 0; i < ARR_SIZE(numbers); i++)
+	{
+		void** found = sorted->binarySearch(sorted, &numbers[i], AComp->intComp);
+		massert(found != NULL && **(int **)found == numbers[i], "Failed to find value");
+	}
+
+	for (i = 0; i < ARR_SIZE(missing); i++)
+	{
+		massert(sorted->binarySearch(sorted, &missing[i], AComp->intComp) == NULL, "Found missing value");
+	}
+
+	sorted->destroy(sorted, NULL);
+
+	/* Search strings sorted by length for a length, which the comparison gets as its second argument */
+	sorted = AStruct->ANew(AVector);
+
+	for (i = 0; i < ARR_SIZE(strings); i++)
+	{
+		sorted->append(sorted, strings[i]);
+	}
+
+	massert(sorted->lowerBound(sorted, &lengths[1], lengthComp) == 1, "Wrong lower bound of a length");
+	massert(sorted->upperBound(sorted, &lengths[1], lengthComp) == 4, "Wrong upper bound of a length");
+	massert(sorted->upperBound(sorted, &lengths[0], lengthComp) == 0, "Wrong upper bound before the lengths");
+	massert(sorted->upperBound(sorted, &lengths[3], lengthComp) == 6, "Wrong upper bound of the last length");
+	massert(sorted->binarySearch(sorted, &lengths[2], lengthComp) == NULL, "Found missing length");
+	massert(*sorted->binarySearch(sorted, &lengths[3], lengthComp) == strings[5], "Failed to find length");
+
+	sorted->destroy(sorted, NULL);
+
+	return NULL;
+}
+
+const char* testFind(void)
+{
+	int numbers[] = { 7, 3, 7, 9 };
+	int seven = 7, missing = 4;
+	char* strings[] = { "foo", "bar", "foo" };
+	AVector* found = AStruct->ANew(AVector);
+	size_t i, size;
+
+	/* Sizes covering every tail of the SIMD loops */
+	for (size = 0; size < 11; size++)
+	{
+		massert(found->indexOf(found, (void *)42, NULL) == AVECTOR_NPOS, "Found missing pointer");
+
+		for (i = 0; i < size; i++)
+		{
+			massert(found->indexOf(found, (void *)i, NULL) == i, "Wrong position of pointer");
+		}
+
+		found->append(found, (void *)size);
+	}
+
+	found->eraseRange(found, 0, found->size, NULL);
+
+	for (i = 0; i < ARR_SIZE(numbers); i++)
+	{
+		found->append(found, &numbers[i]);
+	}
+
+	massert(found->indexOf(found, &seven, AComp->intComp) == 0, "Wrong position of int");
+	massert(found->count(found, &seven, AComp->intComp) == 2, "Wrong count of int");
+	massert(found->count(found, &seven, NULL) == 0, "Counted a different pointer");
+	massert(found->count(found, &numbers[2], NULL) == 1, "Wrong count of pointer");
+	massert(found->find(found, &numbers[3], AComp->pointerComp) == &found->values[3], "Failed to find pointer");
+	massert(!found->contains(found, &missing, AComp->intComp), "Contains missing int");
+
+	found->eraseRange(found, 0, found->size, NULL);
+	found->appendArray(found, (void **)strings, ARR_SIZE(strings));
+	massert(found->count(found, "foo", AComp->stringComp) == 2, "Wrong count of string");
+	massert(found->indexOf(found, "bar", AComp->stringComp) == 1, "Wrong position of string");
+
+	found->destroy(found, NULL);
+
+	return NULL;
+}
+
+static void* doubleValue(void* value)
+{
+	return (void *)((size_t)value * 2);
+}
+
+static int isOddNumber(void* value)
+{
+	return (size_t)value % 2;
+}
+
+static void* sum(void* a, void* b)
+{
+	return (void *)((size_t)a + (size_t)b);
+}
+
+static void* last(void* a, void* b)
+{
+	(void)a;
+	return b;
+}
+
+const char* testMapFilterReduce(void)
+{
+	size_t sizes[] = { 0, 1, 100, 100000 };
+	size_t threads[] = { 1, 3 };
+	size_t i, s, t;
+
+	for (t = 0; t < ARR_SIZE(threads); t++)
+	{
+		AParallel->setThreads(threads[t]);
+
+		for (s = 0; s < ARR_SIZE(sizes); s++)
+		{
+			AVector* values = AStruct->ANew(AVector);
+			AVector* doubled;
+			AVector* odd;
+
+			for (i = 0; i < sizes[s]; i++)
+			{
+				values->append(values, (void *)i);
+			}
+
+			odd = values->filter(values, isOddNumber);
+			massert(odd != NULL && odd->size == sizes[s] / 2, "Wrong size after filter");
+
+			for (i = 0; i < odd->size; i++)
+			{
+				massert(odd->values[i] == (void *)(2 * i + 1), "Wrong values after filter");
+			}
+
+			doubled = values->transform(values, doubleValue);
+			massert(doubled != NULL && doubled->size == sizes[s], "Wrong size after transform");
+			massert(values->map(values, doubleValue) == values, "Failed to map");
+
+			for (i = 0; i < sizes[s]; i++)
+			{
+				massert(values->values[i] == (void *)(2 * i) && doubled->values[i] == values->values[i], "Wrong mapped values");
+			}
+
+			massert((size_t)values->reduce(values, sum, (void *)5) == 5 + sizes[s] * (sizes[s] - (sizes[s] > 0)),
+			        "Wrong sum");
+			massert(odd->reduce(odd, last, NULL) == (odd->size > 0 ? odd->values[odd->size - 1] : NULL),
+			        "Values weren't reduced in order");
+
+			values->destroy(values, NULL);
+			doubled->destroy(doubled, NULL);
+			odd->destroy(odd, NULL);
+		}
+	}
+
+	AParallel->setThreads(0);
+
+	return NULL;
+}
+
+static size_t numFreed = 0;
+
+static void countFree(void* value)
+{
+	numFreed++;
+	free(value);
+}
+
+const char* testView(void)
+{
+	AVector* values = AStruct->ANew(AVector);
+	AVector* page;
+	AVector* inner;
+	AVector* copy;
+	size_t i;
+
+	for (i = 0; i < 100; i++)
+	{
+		values->append(values, (void *)i);
+	}
+
+	massert(values->view(values, 90, 11) == NULL, "Created view past the end");
+	page = values->view(values, 20, 10);
+	massert(page != NULL && page->size == 10 && page->values == values->values + 20, "Wrong view");
+	massert(page->get(page, 0) == (void *)20 && page->get(page, 10) == NULL, "Wrong values of view");
+	massert(page->indexOf(page, (void *)25, NULL) == 5 && !page->contains(page, (void *)30, NULL), "Wrong search in view");
+	massert(page->isSorted(page, AComp->pointerComp), "View isn't sorted");
+
+	/* Views can't change their size, and don't own the values */
+	massert(page->append(page, NULL) == NULL && page->reserve(page, 100) == NULL, "Expanded view");
+	massert(page->remove(page, 0) == NULL && page->eraseRange(page, 0, 5, NULL) == 0, "Removed from view");
+	massert(page->size == 10, "Wrong size of view");
+
+	inner = page->view(page, 5, 5);
+	massert(inner != NULL && inner->get(inner, 4) == (void *)29, "Wrong view of view");
+	copy = inner->copy(inner, NULL);
+	massert(copy != NULL && copy->size == 5 && copy->get(copy, 0) == (void *)25, "Wrong copy of view");
+	massert(copy->append(copy, NULL) != NULL, "Failed to append to copy of view");
+
+	page->set(page, 0, (void *)99);
+	massert(values->get(values, 20) == (void *)99 && !values->isSorted(values, AComp->pointerComp), "Set didn't change vector");
+	massert(values->isSorted(NULL, AComp->pointerComp) == 0, "Invalid vector is sorted");
+
+	inner->destroy(inner, NULL);
+	page->destroy(page, NULL);
+	copy->destroy(copy, NULL);
+	massert(values->size == 100 && values->get(values, 99) == (void *)99, "Destroying views changed vector");
+	values->destroy(values, NULL);
+
+	/* Freeing the values of a view is ignored, as they belong to the vector */
+	values = AStruct->ANew(AVector);
+
+	for (i = 0; i < 10; i++)
+	{
+		values->append(values, AStruct->ADup(testData[i % ARR_SIZE(testData)]));
+	}
+
+	page = values->view(values, 2, 5);
+	page->clear(page, countFree);
+	page->destroy(page, countFree);
+	massert(numFreed == 0 && !strcmp(values->get(values, 2), testData[2]), "Freed the values of a view");
+	values->destroy(values, countFree);
+	massert(numFreed == 10, "Didn't free the values of the vector");
+
+	return NULL;
+}
+
+mrun(testRanges, testBulkAppend, testGrowth, testLocalStorage, testMappedStorage, testSort, testRadixSort, testBinarySearch, testFind,
+     testMapFilterReduce, testView, testCreate, testAppend, testInsert, testReplace, testSet,
      testGet, testRemove, testSubVector, testCopyJoin, testDestroy );